@@ -0,0 +1,93 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSSE3__)
+#include <immintrin.h>
+#define BULK_ENCODER_SHUFFLE
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BULK_ENCODER_SSE2
+#endif
+
+#include "swap.h"
+#include "types.h"
+
+// Big-endian encoding of whole tables. Records are stored as host order 32-bit words straight into
+// the output buffer, then every word of a block of records is swapped at once.
+namespace BulkEncoder
+{
+// Store `value` in host order at byte `offset` of `data`, which doesn't need to be aligned
+inline void storeWord(u8* data, size_t offset, u32 value)
+{
+    std::memcpy(data + offset, &value, sizeof(u32));
+}
+
+// Swap the byte order of `count` 32-bit words stored at `data`, in place. `data` doesn't need to be
+// aligned
+inline void swapWords(u8* data, size_t count)
+{
+    size_t idx = 0;
+
+#if defined(__AVX2__)
+    const auto mask256 = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12, 3,
+                                          2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    for (; idx + 8 <= count; idx += 8)
+    {
+        auto* words = reinterpret_cast<__m256i*>(data + idx * sizeof(u32));
+        _mm256_storeu_si256(words, _mm256_shuffle_epi8(_mm256_loadu_si256(words), mask256));
+    }
+#endif
+
+#if defined(BULK_ENCODER_SHUFFLE)
+    const auto mask = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    for (; idx + 4 <= count; idx += 4)
+    {
+        auto* words = reinterpret_cast<__m128i*>(data + idx * sizeof(u32));
+        _mm_storeu_si128(words, _mm_shuffle_epi8(_mm_loadu_si128(words), mask));
+    }
+#elif defined(BULK_ENCODER_SSE2)
+    // Swap the bytes of every 16-bit half, then the halves of every word
+    for (; idx + 4 <= count; idx += 4)
+    {
+        auto* words = reinterpret_cast<__m128i*>(data + idx * sizeof(u32));
+        auto value = _mm_loadu_si128(words);
+        value = _mm_or_si128(_mm_slli_epi16(value, 8), _mm_srli_epi16(value, 8));
+        value = _mm_shufflelo_epi16(value, _MM_SHUFFLE(2, 3, 0, 1));
+        value = _mm_shufflehi_epi16(value, _MM_SHUFFLE(2, 3, 0, 1));
+        _mm_storeu_si128(words, value);
+    }
+#endif
+
+    for (; idx < count; ++idx)
+    {
+        u32 word;
+        std::memcpy(&word, data + idx * sizeof(u32), sizeof(u32));
+        storeWord(data, idx * sizeof(u32), Common::swap32(word));
+    }
+}
+
+// Encode `count` records of type `Record` at `table`. `fill(record, idx)` stores every field of
+// record `idx` with storeWord, at the field offset in `Record`. The records are swapped a block at
+// a time, while the block is still in cache
+template <typename Record, typename Fill>
+inline void encodeRecords(u8* table, size_t count, const Fill& fill)
+{
+    static_assert(sizeof(Record) % sizeof(u32) == 0, "Records must be made of 32-bit words");
+
+    constexpr size_t cBlockSize = 256;
+    for (size_t first = 0; first < count; first += cBlockSize)
+    {
+        const auto last = std::min(count, first + cBlockSize);
+        for (size_t idx = first; idx < last; ++idx)
+        {
+            fill(table + idx * sizeof(Record), idx);
+        }
+        swapWords(table + first * sizeof(Record), (last - first) * sizeof(Record) / sizeof(u32));
+    }
+}
+}  // namespace BulkEncoder
+
+#undef BULK_ENCODER_SHUFFLE
+#undef BULK_ENCODER_SSE2
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+
+#include "Hash.h"
+#include "elfio/elfio.hpp"
+#include "types.h"
+
+// Skips converting a module whose input and options didn't change since the last conversion.
+// A small stamp file is kept beside every output (`module.rso.cache`) holding the key the output
+// was produced with, plus the output size and hash to detect outputs modified by someone else.
+class ConversionCache
+{
+  private:
+    static constexpr u32 cMagic = 0x43523245;  // E2RC
+    static constexpr u32 cVersion = 1;
+
+    struct Stamp
+    {
+        u32 magic;
+        u32 version;
+        u64 key;
+        u64 outputSize;
+        u64 outputHash;
+    };
+
+    std::atomic<size_t> hitCount{0};
+    std::atomic<size_t> missCount{0};
+
+    static std::filesystem::path stampPath(const std::filesystem::path& output)
+    {
+        auto path = output;
+        path += ".cache";
+        return path;
+    }
+
+    static bool hashFile(const std::filesystem::path& path, u64& size, u64& hash)
+    {
+        ELFIO::mapped_file file;
+        if (!file.open(path.string()))
+        {
+            return false;
+        }
+
+        size = file.size();
+        hash = Hash::bytes(file.data(), file.size());
+        return true;
+    }
+
+  public:
+    // Key of a conversion: content of the input file combined with everything else the output
+    // depends on (`optionsHash`)
+    static bool computeKey(const std::filesystem::path& input, u64 optionsHash, u64& key)
+    {
+        u64 size, hash;
+        if (!hashFile(input, size, hash))
+        {
+            return false;
+        }
+
+        key = Hash::combine(Hash::combine(optionsHash, size), hash);
+        return true;
+    }
+
+    bool isUpToDate(const std::filesystem::path& output, u64 key)
+    {
+        Stamp stamp{};
+        std::ifstream stampFile(stampPath(output), std::ios::binary);
+        stampFile.read(reinterpret_cast<char*>(&stamp), sizeof(stamp));
+
+        u64 outputSize, outputHash;
+        const auto upToDate = stampFile.gcount() == sizeof(stamp) && stamp.magic == cMagic &&
+                              stamp.version == cVersion && stamp.key == key &&
+                              hashFile(output, outputSize, outputHash) &&
+                              stamp.outputSize == outputSize && stamp.outputHash == outputHash;
+
+        ++(upToDate ? hitCount : missCount);
+        return upToDate;
+    }
+
+    void store(const std::filesystem::path& output, u64 key)
+    {
+        Stamp stamp{cMagic, cVersion, key, 0, 0};
+        if (!hashFile(output, stamp.outputSize, stamp.outputHash))
+        {
+            return;
+        }
+
+        std::ofstream stampFile(stampPath(output), std::ios::binary);
+        stampFile.write(reinterpret_cast<const char*>(&stamp), sizeof(stamp));
+    }
+
+    size_t hits() const { return hitCount; }
+    size_t misses() const { return missCount; }
+};
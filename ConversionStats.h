@@ -0,0 +1,142 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "types.h"
+
+// Wall time of every phase of a module conversion, plus counters describing the module.
+// Phases are sequential: starting a phase ends the previous one.
+class ConversionStats
+{
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Phase
+    {
+        std::string name;
+        double milliseconds;
+    };
+
+    struct Counter
+    {
+        std::string name;
+        u64 value;
+    };
+
+    std::vector<Phase> phases;
+    std::vector<Counter> counters;
+
+    std::string currentPhase;
+    Clock::time_point phaseStart;
+
+    static void appendJsonString(std::string& out, const std::string& value)
+    {
+        out += '"';
+        for (const auto chr : value)
+        {
+            if (chr == '"' || chr == '\\')
+            {
+                out += '\\';
+                out += chr;
+            }
+            else if (static_cast<u8>(chr) < 0x20)
+            {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<u8>(chr));
+                out += escaped;
+            }
+            else
+            {
+                out += chr;
+            }
+        }
+        out += '"';
+    }
+
+  public:
+    void phase(std::string name)
+    {
+        endPhase();
+        currentPhase = std::move(name);
+        phaseStart = Clock::now();
+    }
+
+    void endPhase()
+    {
+        if (currentPhase.empty())
+        {
+            return;
+        }
+
+        const std::chrono::duration<double, std::milli> elapsed = Clock::now() - phaseStart;
+        phases.push_back(Phase{std::move(currentPhase), elapsed.count()});
+        currentPhase.clear();
+    }
+
+    void count(std::string name, u64 value) { counters.push_back(Counter{std::move(name), value}); }
+
+    std::string toText(const std::string& module) const
+    {
+        std::string out = "Stats for " + module + "\n";
+        char line[128];
+
+        double total = 0;
+        for (const auto& phase : phases)
+        {
+            std::snprintf(line, sizeof(line), "  %-28s %10.3f ms\n", phase.name.c_str(),
+                          phase.milliseconds);
+            out += line;
+            total += phase.milliseconds;
+        }
+        std::snprintf(line, sizeof(line), "  %-28s %10.3f ms\n", "Total", total);
+        out += line;
+
+        for (const auto& counter : counters)
+        {
+            std::snprintf(line, sizeof(line), "  %-28s %10llu\n", counter.name.c_str(),
+                          static_cast<unsigned long long>(counter.value));
+            out += line;
+        }
+
+        return out;
+    }
+
+    // Single line JSON object, so batch conversions produce one object per line
+    std::string toJson(const std::string& module) const
+    {
+        std::string out = "{\"module\":";
+        appendJsonString(out, module);
+
+        char value[64];
+        out += ",\"phases_ms\":{";
+        for (size_t idx = 0; idx < phases.size(); ++idx)
+        {
+            if (idx != 0)
+            {
+                out += ',';
+            }
+            appendJsonString(out, phases[idx].name);
+            std::snprintf(value, sizeof(value), ":%.3f", phases[idx].milliseconds);
+            out += value;
+        }
+
+        out += "},\"counters\":{";
+        for (size_t idx = 0; idx < counters.size(); ++idx)
+        {
+            if (idx != 0)
+            {
+                out += ',';
+            }
+            appendJsonString(out, counters[idx].name);
+            std::snprintf(value, sizeof(value), ":%llu",
+                          static_cast<unsigned long long>(counters[idx].value));
+            out += value;
+        }
+
+        out += "}}\n";
+        return out;
+    }
+};
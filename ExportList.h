@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "Hash.h"
+#include "StringArena.h"
+
+// Set of symbol names allowed to be exported. An entry can be an exact name, a prefix ending with
+// `*` (e.g. `Game_*`) or a glob using `*` and `?` anywhere in the name.
+class ExportList
+{
+  private:
+    std::unordered_set<std::string_view> names;
+    StringArena nameStorage;
+
+    // Prefix patterns grouped by length, so a lookup costs one hash probe per distinct length
+    std::vector<size_t> prefixLengths;
+    std::unordered_set<std::string_view> prefixes;
+    std::vector<std::string> prefixStorage;
+
+    std::vector<std::string> globs;
+
+    u64 digest = 0;
+
+    static bool matchGlob(std::string_view pattern, std::string_view name)
+    {
+        size_t p = 0, n = 0;
+        size_t starPattern = std::string_view::npos, starName = 0;
+        while (n < name.size())
+        {
+            if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n]))
+            {
+                ++p;
+                ++n;
+            }
+            else if (p < pattern.size() && pattern[p] == '*')
+            {
+                starPattern = p++;
+                starName = n;
+            }
+            else if (starPattern != std::string_view::npos)
+            {
+                p = starPattern + 1;
+                n = ++starName;
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        while (p < pattern.size() && pattern[p] == '*')
+        {
+            ++p;
+        }
+
+        return p == pattern.size();
+    }
+
+  public:
+    ExportList() = default;
+    ExportList(ExportList&&) = default;
+    ExportList& operator=(ExportList&&) = default;
+
+    // `names` and `prefixes` view into their storage, so copies would dangle
+    ExportList(const ExportList&) = delete;
+    ExportList& operator=(const ExportList&) = delete;
+
+    void add(const std::string& entry)
+    {
+        digest = Hash::combine(digest, Hash::bytes(entry.data(), entry.size()));
+
+        const auto wildcard = entry.find_first_of("*?");
+        if (wildcard == std::string::npos)
+        {
+            if (names.find(entry) == names.end())
+            {
+                names.insert(nameStorage.store(entry));
+            }
+        }
+        else if (wildcard == entry.size() - 1 && entry.back() == '*')
+        {
+            prefixStorage.emplace_back(entry, 0, wildcard);
+        }
+        else
+        {
+            globs.push_back(entry);
+        }
+    }
+
+    // Must be called once every entry has been added
+    void compile()
+    {
+        prefixes.clear();
+        prefixLengths.clear();
+        prefixes.reserve(prefixStorage.size());
+        for (const auto& prefix : prefixStorage)
+        {
+            prefixes.insert(prefix);
+            prefixLengths.push_back(prefix.size());
+        }
+
+        std::sort(prefixLengths.begin(), prefixLengths.end());
+        prefixLengths.erase(std::unique(prefixLengths.begin(), prefixLengths.end()),
+                            prefixLengths.end());
+    }
+
+    // Hash of every entry, in order
+    u64 fingerprint() const { return digest; }
+
+    bool contains(std::string_view name) const
+    {
+        if (names.find(name) != names.end())
+        {
+            return true;
+        }
+
+        for (const auto length : prefixLengths)
+        {
+            if (length > name.size())
+            {
+                break;
+            }
+
+            if (prefixes.find(name.substr(0, length)) != prefixes.end())
+            {
+                return true;
+            }
+        }
+
+        for (const auto& glob : globs)
+        {
+            if (matchGlob(glob, name))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+};
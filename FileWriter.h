@@ -1,65 +1,369 @@
 #pragma once
 
+#include <algorithm>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <string_view>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
+#endif
 
 #include "swap.h"
 #include "types.h"
 
+// Builds the whole file in memory and writes it to disk with a single call to `flush`.
+// Ranges copied verbatim from a source file with `copyFrom` aren't held in memory, they are copied
+// file to file on flush. Bytes later patched inside of them are kept aside and written on top.
 class FileWriter
 {
   private:
-    std::ofstream filestream;
+    // Range of the source file copied at `position`. `skipped` is the total size of the ranges
+    // before this one, i.e. how far the buffer lags behind the file positions
+    struct Extent
+    {
+        size_t position;
+        u64 sourceOffset;
+        size_t size;
+        size_t skipped;
+    };
+
+    struct Overlay
+    {
+        size_t position;
+        size_t dataOffset;
+        size_t size;
+    };
+
+    std::filesystem::path filepath;
+    std::vector<u8> buffer;
+    size_t cursor = 0;
+
+    std::filesystem::path sourcePath;
+    std::vector<Extent> extents;
+    std::vector<Overlay> overlays;
+    std::vector<u8> overlayData;
+
+    // First range starting after `position`
+    inline std::vector<Extent>::const_iterator nextExtent(size_t position) const
+    {
+        return std::upper_bound(
+            extents.begin(), extents.end(), position,
+            [](size_t value, const Extent& extent) { return value < extent.position; });
+    }
+
+    // Index inside the buffer of a position outside of the copied ranges
+    inline size_t bufferIndex(size_t position) const
+    {
+        const auto next = nextExtent(position);
+        if (next == extents.begin())
+        {
+            return position;
+        }
+
+        const auto& extent = *(next - 1);
+        return position - extent.skipped - extent.size;
+    }
+
+    inline void put(size_t position, const void* data, size_t size)
+    {
+        const auto* bytes = static_cast<const u8*>(data);
+        while (size != 0)
+        {
+            // Split the write where it enters or leaves a copied range
+            auto length = size;
+            const auto next = nextExtent(position);
+            if (next != extents.begin() && position < (next - 1)->position + (next - 1)->size)
+            {
+                const auto& extent = *(next - 1);
+                length = std::min(length, extent.position + extent.size - position);
+                overlays.push_back({position, overlayData.size(), length});
+                overlayData.insert(overlayData.end(), bytes, bytes + length);
+            }
+            else
+            {
+                if (next != extents.end())
+                {
+                    length = std::min(length, next->position - position);
+                }
+
+                const auto index = bufferIndex(position);
+                if (index + length > buffer.size())
+                {
+                    buffer.resize(index + length);
+                }
+                std::memcpy(buffer.data() + index, bytes, length);
+            }
+
+            position += length;
+            bytes += length;
+            size -= length;
+        }
+    }
+
+    inline size_t copiedSize() const
+    {
+        return extents.empty() ? 0 : extents.back().skipped + extents.back().size;
+    }
+
+#ifndef _WIN32
+    static bool writeAt(int file, const u8* data, size_t size, u64 offset)
+    {
+        while (size != 0)
+        {
+            const auto written = pwrite(file, data, size, static_cast<off_t>(offset));
+            if (written <= 0)
+            {
+                return false;
+            }
+
+            data += written;
+            size -= static_cast<size_t>(written);
+            offset += static_cast<u64>(written);
+        }
+        return true;
+    }
+
+    // Copy in the kernel when possible, through a small bounce buffer otherwise
+    static bool copyAt(int source, u64 sourceOffset, int file, u64 offset, size_t size)
+    {
+#ifdef __linux__
+        auto in = static_cast<loff_t>(sourceOffset);
+        auto out = static_cast<loff_t>(offset);
+        while (size != 0)
+        {
+            const auto copied = copy_file_range(source, &in, file, &out, size, 0);
+            if (copied <= 0)
+            {
+                break;
+            }
+            size -= static_cast<size_t>(copied);
+        }
+
+        // Not supported between these files, sendfile writes at the current position
+        if (size != 0 && lseek(file, static_cast<off_t>(out), SEEK_SET) == out)
+        {
+            auto inOffset = static_cast<off_t>(in);
+            while (size != 0)
+            {
+                const auto copied = sendfile(file, source, &inOffset, size);
+                if (copied <= 0)
+                {
+                    break;
+                }
+                size -= static_cast<size_t>(copied);
+                out += copied;
+            }
+            in = inOffset;
+        }
+
+        sourceOffset = static_cast<u64>(in);
+        offset = static_cast<u64>(out);
+#endif
+
+        u8 chunk[0x10000];
+        while (size != 0)
+        {
+            const auto read = pread(source, chunk, std::min(size, sizeof(chunk)),
+                                    static_cast<off_t>(sourceOffset));
+            if (read <= 0 || !writeAt(file, chunk, static_cast<size_t>(read), offset))
+            {
+                return false;
+            }
+
+            size -= static_cast<size_t>(read);
+            sourceOffset += static_cast<u64>(read);
+            offset += static_cast<u64>(read);
+        }
+        return true;
+    }
+
+    bool flushExtents(const std::filesystem::path& path)
+    {
+        const auto source = open(sourcePath.c_str(), O_RDONLY);
+        if (source < 0)
+        {
+            return false;
+        }
+
+        const auto file = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (file < 0)
+        {
+            close(source);
+            return false;
+        }
+
+#ifdef __linux__
+        // Allocate the whole file at once, not every file system supports it
+        fallocate(file, 0, 0, static_cast<off_t>(size()));
+#endif
+
+        auto result = true;
+        size_t index = 0;
+        for (const auto& extent : extents)
+        {
+            const auto staged = extent.position - extent.skipped - index;
+            result = result &&
+                     writeAt(file, buffer.data() + index, staged, extent.position - staged);
+            result = result &&
+                     copyAt(source, extent.sourceOffset, file, extent.position, extent.size);
+            index += staged;
+        }
+        result = result && writeAt(file, buffer.data() + index, buffer.size() - index,
+                                   index + copiedSize());
+
+        for (const auto& overlay : overlays)
+        {
+            result = result && writeAt(file, overlayData.data() + overlay.dataOffset, overlay.size,
+                                       overlay.position);
+        }
+
+        close(source);
+        return close(file) == 0 && result;
+    }
+#else
+    bool flushExtents(const std::filesystem::path& path)
+    {
+        std::ifstream source(sourcePath, std::ios::binary);
+        std::ofstream filestream(path, std::ios::binary);
+
+        std::vector<char> chunk(0x10000);
+        size_t index = 0;
+        for (const auto& extent : extents)
+        {
+            const auto staged = extent.position - extent.skipped - index;
+            filestream.write(reinterpret_cast<const char*>(buffer.data() + index),
+                             static_cast<std::streamsize>(staged));
+            index += staged;
+
+            source.seekg(static_cast<std::streamoff>(extent.sourceOffset));
+            for (auto size = extent.size; size != 0 && source;)
+            {
+                const auto length = std::min(size, chunk.size());
+                source.read(chunk.data(), static_cast<std::streamsize>(length));
+                filestream.write(chunk.data(), static_cast<std::streamsize>(length));
+                size -= length;
+            }
+        }
+        filestream.write(reinterpret_cast<const char*>(buffer.data() + index),
+                         static_cast<std::streamsize>(buffer.size() - index));
+
+        for (const auto& overlay : overlays)
+        {
+            filestream.seekp(static_cast<std::streamoff>(overlay.position));
+            filestream.write(reinterpret_cast<const char*>(overlayData.data() + overlay.dataOffset),
+                             static_cast<std::streamsize>(overlay.size));
+        }
+
+        return source.good() && filestream.good();
+    }
+#endif
 
   public:
-    FileWriter(std::filesystem::path filepath) : filestream(filepath, std::ios::binary) {}
+    FileWriter(std::filesystem::path filepath) : filepath(std::move(filepath)) {}
+
+    inline void writeString(const std::string& data)
+    {
+        // Null terminated
+        write(data.c_str(), data.size() + 1);
+    }
 
+    inline void write(const char* data, size_t size)
+    {
+        put(cursor, data, size);
+        cursor += size;
+    }
+
+    // Overwrite previously written bytes without moving the write position
     template <typename T>
-    inline void writeBE(T data)
+    inline void patchBE(size_t position, T data)
     {
         static_assert(std::is_arithmetic<T>::value,
                       "function only makes sense with arithmetic types");
 
         Common::swap<sizeof(data)>(reinterpret_cast<u8*>(&data));
-        write(data);
+        patch(position, data);
     }
 
     template <typename T>
-    inline void write(T data)
+    inline void patch(size_t position, T data)
     {
         static_assert(std::is_arithmetic<T>::value,
                       "function only makes sense with arithmetic types");
 
-        filestream.write(reinterpret_cast<const char*>(&data), sizeof(data));
+        put(position, &data, sizeof(data));
     }
 
-    inline void writeString(const std::string& data)
+    // Copy `size` bytes of `source` starting at `offset` when the file is flushed. Every range must
+    // come from the same source, which must not change until then. The source may be the output
+    // file itself
+    inline void copyFrom(const std::filesystem::path& source, u64 offset, size_t size)
     {
-        filestream.write(data.c_str(), data.size());
-        filestream << '\0';  // Null terminated
+        sourcePath = source;
+        if (size == 0)
+        {
+            return;
+        }
+
+        // The buffer must reach the write position before the range starts
+        const auto index = bufferIndex(cursor);
+        if (index > buffer.size())
+        {
+            buffer.resize(index);
+        }
+
+        extents.push_back({cursor, offset, size, copiedSize()});
+        cursor += size;
     }
 
-    inline void write(const char* data, size_t size) { filestream.write(data, size); }
+    // Previously written bytes outside of the copied ranges. The pointer is valid until the next
+    // write
+    inline u8* data(size_t position) { return buffer.data() + bufferIndex(position); }
+
+    inline size_t position() { return cursor; }
 
-    inline size_t position() { return static_cast<size_t>(filestream.tellp()); }
+    inline size_t size() { return buffer.size() + copiedSize(); }
 
-    inline void seek(size_t position) { filestream.seekp(static_cast<size_t>(position), std::ios::beg); }
+    inline void seek(size_t position) { cursor = position; }
 
-    inline void padToAlignment(size_t alignment)
+    // Grow or shrink the file to `size` bytes, new bytes are zeroed. The copied ranges must stay
+    // inside the file
+    inline void resize(size_t size) { buffer.resize(size - copiedSize()); }
+
+    inline bool flush()
     {
-        if (alignment == 0)
+        if (!extents.empty())
         {
-            return;
-        }
+            // The output may be the source itself (e.g. `-i module.rso`), truncating it would lose
+            // the ranges still to be copied. The file is written beside it and then replaces it
+            auto temporaryPath = filepath;
+            temporaryPath += ".tmp";
 
-        auto pos = position();
-        auto count = (~(alignment - 1U) & (alignment + pos) - 1U) - pos;
+            std::error_code error;
+            if (!flushExtents(temporaryPath))
+            {
+                std::filesystem::remove(temporaryPath, error);
+                return false;
+            }
 
-        u8 b = 0;
-        for (; count > 0; --count)
-        {
-            filestream.write(reinterpret_cast<const char*>(&b), sizeof(b));
+            std::filesystem::rename(temporaryPath, filepath, error);
+            if (error)
+            {
+                std::filesystem::remove(temporaryPath, error);
+                return false;
+            }
+            return true;
         }
+
+        std::ofstream filestream(filepath, std::ios::binary);
+        filestream.write(reinterpret_cast<const char*>(buffer.data()),
+                         static_cast<std::streamsize>(buffer.size()));
+        return filestream.good();
     }
-};
\ No newline at end of file
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstring>
+
+#include "types.h"
+
+namespace Hash
+{
+inline u64 mix(u64 value)
+{
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ULL;
+    value ^= value >> 33;
+    return value;
+}
+
+inline u64 combine(u64 seed, u64 value)
+{
+    return mix(seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)));
+}
+
+// Fast non-cryptographic 64-bit hash, reads the input 8 bytes at a time
+inline u64 bytes(const void* data, size_t size, u64 seed = 0)
+{
+    const auto* ptr = static_cast<const u8*>(data);
+    u64 hash = seed ^ (size * 0x9e3779b97f4a7c15ULL);
+
+    for (; size >= 8; size -= 8, ptr += 8)
+    {
+        u64 word;
+        std::memcpy(&word, ptr, sizeof(word));
+        hash = (hash ^ mix(word)) * 0x9e3779b97f4a7c15ULL;
+    }
+
+    u64 tail = 0;
+    std::memcpy(&tail, ptr, size);
+    hash ^= mix(tail);
+
+    return mix(hash);
+}
+}  // namespace Hash
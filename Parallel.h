@@ -0,0 +1,51 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Number of threads used when the user doesn't ask for a specific amount
+inline unsigned defaultJobCount()
+{
+    const auto count = std::thread::hardware_concurrency();
+    return count == 0 ? 1 : count;
+}
+
+// Run `task(index)` for every index in [0, count) using up to `jobs` threads, the calling thread
+// included. Idle workers grab the next pending index, so a slow item never holds back the rest.
+template <typename Task>
+void parallelFor(size_t count, unsigned jobs, Task&& task)
+{
+    const auto threadCount = std::min(static_cast<size_t>(std::max(jobs, 1u)), count);
+    if (threadCount <= 1)
+    {
+        for (size_t idx = 0; idx < count; ++idx)
+        {
+            task(idx);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    const auto worker = [&]() {
+        for (auto idx = next.fetch_add(1); idx < count; idx = next.fetch_add(1))
+        {
+            task(idx);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    for (size_t idx = 1; idx < threadCount; ++idx)
+    {
+        threads.emplace_back(worker);
+    }
+
+    worker();
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
@@ -1,5 +1,12 @@
 #pragma once
 
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+#include "swap.h"
+#include "types.h"
+
 struct RSOHeader
 {
     u32 next_module_link;
@@ -50,15 +57,94 @@ enum RSORelocationType
     R_PPC_REL14,
 };
 
-struct RSORelocation
+// Relocations stored as one array per field (15 bytes per entry, no padding). Tables are reordered
+// through a permutation of indices, so sorting only moves the fields once.
+class RSORelocationTable
 {
-    u32 symbolHash;
-    u32 symbolIndex;
-    uint32_t section;
-    uint32_t offset;
-    uint8_t targetSection;  // target symbol
-    uint32_t addend;
-    uint8_t type;
+  public:
+    std::vector<u32> offset;   // Relative to `section`
+    std::vector<u32> symbol;   // Internal: section of the target. External: imported symbol index
+    std::vector<u32> addend;
+    std::vector<u16> section;  // Section being patched
+    std::vector<u8> type;
+
+    size_t size() const { return offset.size(); }
+
+    void reserve(size_t count)
+    {
+        offset.reserve(count);
+        symbol.reserve(count);
+        addend.reserve(count);
+        section.reserve(count);
+        type.reserve(count);
+    }
+
+    void push(u16 relocationSection, u32 relocationOffset, u8 relocationType, u32 relocationSymbol,
+              u32 relocationAddend)
+    {
+        offset.push_back(relocationOffset);
+        symbol.push_back(relocationSymbol);
+        addend.push_back(relocationAddend);
+        section.push_back(relocationSection);
+        type.push_back(relocationType);
+    }
+
+    void append(const RSORelocationTable& other)
+    {
+        offset.insert(offset.end(), other.offset.begin(), other.offset.end());
+        symbol.insert(symbol.end(), other.symbol.begin(), other.symbol.end());
+        addend.insert(addend.end(), other.addend.begin(), other.addend.end());
+        section.insert(section.end(), other.section.begin(), other.section.end());
+        type.insert(type.end(), other.type.begin(), other.type.end());
+    }
+
+    // Copy the entry `from` over the entry `to`, used to remove entries in place
+    void move(size_t from, size_t to)
+    {
+        offset[to] = offset[from];
+        symbol[to] = symbol[from];
+        addend[to] = addend[from];
+        section[to] = section[from];
+        type[to] = type[from];
+    }
+
+    void resize(size_t count)
+    {
+        offset.resize(count);
+        symbol.resize(count);
+        addend.resize(count);
+        section.resize(count);
+        type.resize(count);
+    }
+
+    bool equal(size_t left, size_t right) const
+    {
+        return offset[left] == offset[right] && symbol[left] == symbol[right] &&
+               addend[left] == addend[right] && section[left] == section[right] &&
+               type[left] == type[right];
+    }
+
+    // Reorder the entries, `order[idx]` is the current index of the entry moved to `idx`
+    void permute(const std::vector<u32>& order)
+    {
+        permuteField(offset, order);
+        permuteField(symbol, order);
+        permuteField(addend, order);
+        permuteField(section, order);
+        permuteField(type, order);
+    }
+
+  private:
+    template <typename T>
+    static void permuteField(std::vector<T>& field, const std::vector<u32>& order)
+    {
+        std::vector<T> sorted(order.size());
+        for (size_t idx = 0; idx < order.size(); ++idx)
+        {
+            sorted[idx] = field[order[idx]];
+        }
+        field.swap(sorted);
+    }
 };
 
 struct RSOSectionInfo
@@ -70,8 +156,91 @@ struct RSOSectionInfo
 struct RSOSymbol
 {
     u32 hash;
-    std::string symbol;
+    std::string_view symbol;  // Points into the .strtab of the input ELF
     u32 sectionIndex;
     u32 sectionRelativeOffset;  // For exported symbol this mean the symbol offset, for imported
                                 // symbol this mean the relocation offset
-};
\ No newline at end of file
+};
+// On-disk layouts. The fields are stored in the byte order of the file: the header is written as
+// is, and the tables are encoded field by field at the offsets of these records. The field offsets
+// are checked below.
+using be32 = Common::BigEndianValue<u32>;
+
+struct RSOHeaderRecord
+{
+    be32 next_module_link;
+    be32 prev_module_link;
+    be32 section_count;
+    be32 section_info_offset;
+    be32 module_name_offset;
+    be32 module_name_size;
+    be32 module_version;
+    be32 bss_size;
+    u8 prolog_section_index;
+    u8 epilog_section_index;
+    u8 unresolved_section_index;
+    u8 bss_section_index;
+    be32 prolog_function_offset;
+    be32 epilog_function_offset;
+    be32 unresolved_function_offset;
+    be32 internal_relocation_table_offset;
+    be32 internal_relocation_table_size;
+    be32 external_relocation_table_offset;
+    be32 external_relocation_table_size;
+    be32 export_symbol_table_offset;
+    be32 export_symbol_table_size;
+    be32 export_symbol_names_offset;
+    be32 import_symbol_table_offset;
+    be32 import_symbol_table_size;
+    be32 import_symbol_names_offset;
+};
+
+struct RSOSectionInfoRecord
+{
+    be32 offset;
+    be32 size;
+};
+
+struct RSOExportRecord
+{
+    be32 name_offset;
+    be32 offset;
+    be32 section_index;
+    u32 hash;  // Stored in host order
+};
+
+struct RSOImportRecord
+{
+    be32 name_offset;
+    be32 offset;
+    be32 first_relocation_offset;
+};
+
+struct RSORelocationRecord
+{
+    be32 offset;  // Relative to the start of the file
+    be32 info;    // (symbol << 8) | type
+    be32 addend;
+};
+
+static_assert(sizeof(RSOHeaderRecord) == 0x58, "RSO header size");
+static_assert(offsetof(RSOHeaderRecord, section_count) == 0x08, "RSO header layout");
+static_assert(offsetof(RSOHeaderRecord, module_name_offset) == 0x10, "RSO header layout");
+static_assert(offsetof(RSOHeaderRecord, bss_size) == 0x1c, "RSO header layout");
+static_assert(offsetof(RSOHeaderRecord, prolog_section_index) == 0x20, "RSO header layout");
+static_assert(offsetof(RSOHeaderRecord, prolog_function_offset) == 0x24, "RSO header layout");
+static_assert(offsetof(RSOHeaderRecord, internal_relocation_table_offset) == 0x30,
+              "RSO header layout");
+static_assert(offsetof(RSOHeaderRecord, external_relocation_table_offset) == 0x38,
+              "RSO header layout");
+static_assert(offsetof(RSOHeaderRecord, export_symbol_table_offset) == 0x40, "RSO header layout");
+static_assert(offsetof(RSOHeaderRecord, import_symbol_table_offset) == 0x4c, "RSO header layout");
+static_assert(offsetof(RSOHeaderRecord, import_symbol_names_offset) == 0x54, "RSO header layout");
+
+static_assert(sizeof(RSOSectionInfoRecord) == 8, "RSO section info size");
+static_assert(sizeof(RSOExportRecord) == 16, "RSO export size");
+static_assert(offsetof(RSOExportRecord, hash) == 12, "RSO export layout");
+static_assert(sizeof(RSOImportRecord) == 12, "RSO import size");
+static_assert(offsetof(RSOImportRecord, first_relocation_offset) == 8, "RSO import layout");
+static_assert(sizeof(RSORelocationRecord) == 12, "RSO relocation size");
+static_assert(offsetof(RSORelocationRecord, addend) == 8, "RSO relocation layout");
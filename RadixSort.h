@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "types.h"
+
+// Stable LSD radix sort of the indices [0, count) by the 64-bit key returned by `key(index)`, in
+// ascending order. Returns the sorted indices. Keys are sorted one byte at a time along with the
+// indices and the bytes that are the same in every key are skipped.
+template <typename KeyFunction>
+std::vector<u32> radixSortOrder(size_t count, KeyFunction key)
+{
+    std::vector<u64> keys(count);
+    std::vector<u32> order(count);
+    for (size_t idx = 0; idx < count; ++idx)
+    {
+        keys[idx] = key(idx);
+        order[idx] = static_cast<u32>(idx);
+    }
+
+    if (count < 2)
+    {
+        return order;
+    }
+
+    // Histogram of every byte, computed in a single pass over the keys
+    std::vector<std::array<size_t, 256>> histograms(sizeof(u64));
+    for (auto& histogram : histograms)
+    {
+        histogram.fill(0);
+    }
+
+    for (const auto value : keys)
+    {
+        for (size_t byte = 0; byte < sizeof(u64); ++byte)
+        {
+            ++histograms[byte][(value >> (byte * 8)) & 0xff];
+        }
+    }
+
+    std::vector<u64> sortedKeys(count);
+    std::vector<u32> sortedOrder(count);
+    for (size_t byte = 0; byte < sizeof(u64); ++byte)
+    {
+        auto& histogram = histograms[byte];
+        if (histogram[(keys[0] >> (byte * 8)) & 0xff] == count)
+        {
+            continue;
+        }
+
+        size_t offset = 0;
+        for (auto& bucket : histogram)
+        {
+            const auto size = bucket;
+            bucket = offset;
+            offset += size;
+        }
+
+        for (size_t idx = 0; idx < count; ++idx)
+        {
+            const auto position = histogram[(keys[idx] >> (byte * 8)) & 0xff]++;
+            sortedKeys[position] = keys[idx];
+            sortedOrder[position] = order[idx];
+        }
+
+        keys.swap(sortedKeys);
+        order.swap(sortedOrder);
+    }
+
+    return order;
+}
+
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <array>
+#include <string_view>
+#include <vector>
+
+#include "types.h"
+
+#include "elfio/elfio.hpp"
+
+// Sections copied to the module
+// @Source: PistonMiner's elf2rel
+constexpr std::array<std::string_view, 7> cModuleSections = {
+    ".init", ".text", ".ctors", ".dtors", ".rodata", ".data", ".bss",
+};
+
+// Perfect hash of the module section names, from their 2nd and 3rd characters. `name` must be at
+// least 3 characters long
+constexpr size_t cModuleSectionSlots = 8;
+
+constexpr size_t moduleSectionSlot(std::string_view name)
+{
+    return (static_cast<u8>(name[1]) * 2u + static_cast<u8>(name[2])) % cModuleSectionSlots;
+}
+
+// Index in `cModuleSections` of the name in every slot, -1 for the empty slots. Empty when two
+// names share a slot
+constexpr std::array<s8, cModuleSectionSlots> buildModuleSectionSlots()
+{
+    std::array<s8, cModuleSectionSlots> slots{};
+    for (auto& slot : slots)
+    {
+        slot = -1;
+    }
+
+    for (size_t idx = 0; idx < cModuleSections.size(); ++idx)
+    {
+        auto& slot = slots[moduleSectionSlot(cModuleSections[idx])];
+        if (slot != -1)
+        {
+            return {};
+        }
+        slot = static_cast<s8>(idx);
+    }
+
+    return slots;
+}
+
+constexpr auto cModuleSectionSlotTable = buildModuleSectionSlots();
+
+constexpr bool isModuleSectionHashPerfect()
+{
+    for (size_t idx = 0; idx < cModuleSections.size(); ++idx)
+    {
+        const auto slot = moduleSectionSlot(cModuleSections[idx]);
+        if (cModuleSectionSlotTable[slot] != static_cast<s8>(idx))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(isModuleSectionHashPerfect(),
+              "The module section names must have a slot of their own");
+
+// Whether `name` is a module section name. With `prefix`, `name` only has to start with the
+// module section name
+constexpr bool findModuleSection(std::string_view name, bool prefix)
+{
+    if (name.size() < 3)
+    {
+        return false;
+    }
+
+    const auto entry = cModuleSectionSlotTable[moduleSectionSlot(name)];
+    if (entry == -1)
+    {
+        return false;
+    }
+
+    const auto section = cModuleSections[static_cast<size_t>(entry)];
+    return prefix ? name.substr(0, section.size()) == section : name == section;
+}
+
+static_assert(findModuleSection(".rodata", false), "Module section lookup");
+static_assert(findModuleSection(".text.main", true), "Module section lookup");
+static_assert(!findModuleSection(".text.main", false), "Module section lookup");
+static_assert(!findModuleSection(".sdata", false), "Module section lookup");
+
+// Classification of every section of the input, found once from the section names. Relocation
+// sections (".rela" followed by the name of a module section, or the start of it) belong to the
+// module section they relocate.
+class SectionTable
+{
+  private:
+    struct Entry
+    {
+        bool module = false;
+        bool relocation = false;
+    };
+
+    std::vector<Entry> entries;
+
+  public:
+    explicit SectionTable(const ELFIO::elfio& inputElf)
+    {
+        // Names are read straight from the section name table, without copying them
+        const ELFIO::section* nameTable = inputElf.sections[inputElf.get_section_name_str_index()];
+        const char* names = nameTable ? nameTable->get_data() : nullptr;
+        const size_t namesSize = names ? static_cast<size_t>(nameTable->get_size()) : 0;
+
+        entries.resize(inputElf.sections.size());
+        for (size_t idx = 0; idx < entries.size(); ++idx)
+        {
+            const auto offset = inputElf.sections[idx]->get_name_string_offset();
+            if (offset >= namesSize)
+            {
+                continue;
+            }
+
+            std::string_view name(names + offset, namesSize - offset);
+            name = name.substr(0, name.find('\0'));
+
+            constexpr std::string_view cRelocationPrefix = ".rela";
+            auto& entry = entries[idx];
+            if (name.substr(0, cRelocationPrefix.size()) == cRelocationPrefix)
+            {
+                entry.relocation = true;
+                entry.module = findModuleSection(name.substr(cRelocationPrefix.size()), true);
+            }
+            else
+            {
+                entry.module = findModuleSection(name, false);
+            }
+        }
+    }
+
+    // Section copied to the module
+    bool isModuleSection(size_t index) const
+    {
+        return !entries[index].relocation && entries[index].module;
+    }
+
+    // Relocations of a module section
+    bool isModuleRelocation(size_t index) const
+    {
+        return entries[index].relocation && entries[index].module;
+    }
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Bump allocator for strings. Strings are copied into fixed blocks and never move, so the returned
+// views stay valid for the lifetime of the arena. Long strings get a block of their own.
+class StringArena
+{
+  private:
+    static constexpr size_t cBlockSize = 0x10000;
+
+    std::vector<std::unique_ptr<char[]>> blocks;
+    std::vector<std::unique_ptr<char[]>> largeStrings;
+    size_t blockUsed = cBlockSize;
+
+  public:
+    StringArena() = default;
+    StringArena(StringArena&&) = default;
+    StringArena& operator=(StringArena&&) = default;
+
+    std::string_view store(std::string_view text)
+    {
+        if (text.size() > cBlockSize / 4)
+        {
+            largeStrings.emplace_back(new char[text.size()]);
+            std::copy(text.begin(), text.end(), largeStrings.back().get());
+            return {largeStrings.back().get(), text.size()};
+        }
+
+        if (blockUsed + text.size() > cBlockSize)
+        {
+            blocks.emplace_back(new char[cBlockSize]);
+            blockUsed = 0;
+        }
+
+        auto* destination = blocks.back().get() + blockUsed;
+        std::copy(text.begin(), text.end(), destination);
+        blockUsed += text.size();
+        return {destination, text.size()};
+    }
+};
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "Hash.h"
+#include "StringArena.h"
+#include "types.h"
+
+// Set of symbol names shared by every module of a batch. Each name is stored once and the returned
+// views stay valid for the lifetime of the table. The table is split in shards with their own lock,
+// so modules converted in parallel rarely wait on each other.
+class SymbolInternTable
+{
+  private:
+    struct NameHash
+    {
+        size_t operator()(std::string_view name) const
+        {
+            return static_cast<size_t>(Hash::bytes(name.data(), name.size()));
+        }
+    };
+
+    static constexpr size_t cShardCount = 16;
+
+    struct Shard
+    {
+        mutable std::mutex mutex;
+        std::unordered_set<std::string_view, NameHash> names;
+        StringArena storage;
+    };
+
+    std::array<Shard, cShardCount> shards;
+
+    // The set buckets use the low bits of the hash, the shard is picked from the high ones
+    static size_t shardIndex(std::string_view name)
+    {
+        return static_cast<size_t>(Hash::bytes(name.data(), name.size()) >> 60) % cShardCount;
+    }
+
+  public:
+    SymbolInternTable() = default;
+
+    // Shards hold locks and views into their own blocks
+    SymbolInternTable(const SymbolInternTable&) = delete;
+    SymbolInternTable& operator=(const SymbolInternTable&) = delete;
+
+    std::string_view intern(std::string_view name)
+    {
+        auto& shard = shards[shardIndex(name)];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        const auto it = shard.names.find(name);
+        if (it != shard.names.end())
+        {
+            return *it;
+        }
+
+        const auto stored = shard.storage.store(name);
+        shard.names.insert(stored);
+        return stored;
+    }
+
+    bool contains(std::string_view name) const
+    {
+        const auto& shard = shards[shardIndex(name)];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.names.find(name) != shard.names.end();
+    }
+
+    size_t size() const
+    {
+        size_t count = 0;
+        for (const auto& shard : shards)
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            count += shard.names.size();
+        }
+        return count;
+    }
+
+    // Hash of every interned name. It doesn't depend on the order the names were added
+    u64 fingerprint() const
+    {
+        u64 digest = 0;
+        for (const auto& shard : shards)
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            for (const auto name : shard.names)
+            {
+                digest += Hash::mix(Hash::bytes(name.data(), name.size()));
+            }
+        }
+        return digest;
+    }
+};
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Hash.h"
+#include "RSO.h"
+#include "StringArena.h"
+#include "types.h"
+
+#include "elfio/elfio.hpp"
+
+// Fixed addresses of the symbols defined by the static module. Used to resolve the imports of a
+// dynamic module at build time instead of leaving them to the loader.
+class SymbolMap
+{
+  private:
+    StringArena names;
+    std::unordered_map<std::string_view, u32> addresses;
+    u64 digest = 0;
+
+    void add(std::string_view name, u32 address)
+    {
+        digest = Hash::combine(digest, Hash::bytes(name.data(), name.size(), address));
+        if (addresses.find(name) == addresses.end())
+        {
+            addresses.emplace(names.store(name), address);
+        }
+    }
+
+    // Export table of a static module. Every export uses the section index 0 and its absolute
+    // address as the offset
+    bool loadStaticModule(const std::vector<u8>& data)
+    {
+        RSOHeaderRecord header;
+        if (data.size() < sizeof(header))
+        {
+            return false;
+        }
+
+        std::memcpy(&header, data.data(), sizeof(header));
+        if (header.section_count != 0)
+        {
+            return false;
+        }
+
+        const auto tableOffset = static_cast<size_t>(header.export_symbol_table_offset);
+        const auto tableSize = static_cast<size_t>(header.export_symbol_table_size);
+        const auto namesOffset = static_cast<size_t>(header.export_symbol_names_offset);
+        if (tableOffset + tableSize > data.size() || namesOffset > data.size())
+        {
+            return false;
+        }
+
+        for (size_t entry = tableOffset; entry + sizeof(RSOExportRecord) <= tableOffset + tableSize;
+             entry += sizeof(RSOExportRecord))
+        {
+            RSOExportRecord record;
+            std::memcpy(&record, data.data() + entry, sizeof(record));
+
+            const auto nameOffset = namesOffset + record.name_offset;
+            if (nameOffset >= data.size() || record.section_index != 0)
+            {
+                continue;
+            }
+
+            std::string_view name(reinterpret_cast<const char*>(data.data() + nameOffset),
+                                  data.size() - nameOffset);
+            name = name.substr(0, name.find('\0'));
+            add(name, record.offset);
+        }
+
+        return true;
+    }
+
+    // Global symbols of the executable ELF the static module is created from
+    bool loadExecutable(const std::filesystem::path& input)
+    {
+        ELFIO::elfio inputElf;
+        if ((!inputElf.load_mapped(input.string()) && !inputElf.load(input.string())) ||
+            inputElf.get_type() != ET_EXEC || inputElf.get_class() != ELFCLASS32)
+        {
+            return false;
+        }
+
+        for (const auto& section : inputElf.sections)
+        {
+            if (section->get_type() != SHT_SYMTAB)
+            {
+                continue;
+            }
+
+            ELFIO::symbol_section_accessor symbols(inputElf, section);
+            for (const auto& symbol : symbols.get_view<ELFIO::Elf32_Sym>())
+            {
+                if (symbol.name.empty() || symbol.bind == STB_LOCAL ||
+                    symbol.section_index == SHN_UNDEF || symbol.type == STT_SECTION ||
+                    symbol.type == STT_FILE)
+                {
+                    continue;
+                }
+
+                add(symbol.name, static_cast<u32>(symbol.value));
+            }
+            break;
+        }
+
+        return true;
+    }
+
+  public:
+    SymbolMap() = default;
+
+    // Accepts a static module (.sel) or the executable ELF it's created from
+    bool load(const std::filesystem::path& input)
+    {
+        std::ifstream inputFile(input, std::ios::binary);
+        if (!inputFile)
+        {
+            return false;
+        }
+
+        char magic[4] = {};
+        inputFile.read(magic, sizeof(magic));
+        if (magic[0] == ELFMAG0 && magic[1] == ELFMAG1 && magic[2] == ELFMAG2 &&
+            magic[3] == ELFMAG3)
+        {
+            return loadExecutable(input);
+        }
+
+        inputFile.clear();
+        inputFile.seekg(0);
+        std::vector<u8> data((std::istreambuf_iterator<char>(inputFile)),
+                             std::istreambuf_iterator<char>());
+
+        return loadStaticModule(data);
+    }
+
+    bool find(std::string_view name, u32& address) const
+    {
+        const auto it = addresses.find(name);
+        if (it == addresses.end())
+        {
+            return false;
+        }
+
+        address = it->second;
+        return true;
+    }
+
+    size_t size() const { return addresses.size(); }
+
+    // Hash of every symbol and address, in order
+    u64 fingerprint() const { return digest; }
+};
@@ -0,0 +1,154 @@
+// Times the ways of reading the ELF tables of a big-endian ELF: the ELFIO accessors the converter
+// used to go through (get_symbol and get_entry, which check the ELF class and convert the byte
+// order at run time on every call), and the allocation-free table views with the run-time
+// convertor and with the convertor fixed at compile time that the converter uses now. Every symbol
+// and relocation is decoded the same way the converter does.
+//
+// Usage: elf_reader_bench <input.elf> [passes]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "types.h"
+
+#include "elfio/elfio.hpp"
+
+// Decode every symbol and relocation of the input through the accessors, one copied name and
+// class check per call. The sum of the fields keeps the reads alive and checks that every reader
+// agrees
+u64 readAccessors(ELFIO::elfio& inputElf)
+{
+    u64 sum = 0;
+    std::string name;
+    for (const auto& section : inputElf.sections)
+    {
+        if (section->get_type() == SHT_SYMTAB)
+        {
+            const ELFIO::symbol_section_accessor symbols(inputElf, section);
+            for (ELFIO::Elf_Xword idx = 0; idx < symbols.get_symbols_num(); ++idx)
+            {
+                ELFIO::Elf64_Addr value;
+                ELFIO::Elf_Xword size;
+                unsigned char bind, type, other;
+                ELFIO::Elf_Half sectionIndex;
+                symbols.get_symbol(idx, name, value, size, bind, type, sectionIndex, other);
+                sum += value + size + sectionIndex + name.size();
+            }
+        }
+        else if (section->get_type() == SHT_RELA)
+        {
+            const ELFIO::relocation_section_accessor relocations(inputElf, section);
+            for (ELFIO::Elf_Xword idx = 0; idx < relocations.get_entries_num(); ++idx)
+            {
+                ELFIO::Elf64_Addr offset;
+                ELFIO::Elf_Word symbol, type;
+                ELFIO::Elf_Sxword addend;
+                relocations.get_entry(idx, offset, symbol, type, addend);
+                sum += offset + symbol + type + static_cast<u64>(addend);
+            }
+        }
+    }
+    return sum;
+}
+
+// Same through the table views, with the byte order converted by `convertor`
+template <typename Convertor>
+u64 readViews(ELFIO::elfio& inputElf, const Convertor& convertor)
+{
+    u64 sum = 0;
+    for (const auto& section : inputElf.sections)
+    {
+        if (section->get_type() == SHT_SYMTAB)
+        {
+            const ELFIO::symbol_section_accessor symbols(inputElf, section);
+            for (const auto& symbol : symbols.get_view<ELFIO::Elf32_Sym>(convertor))
+            {
+                sum += symbol.value + symbol.size + symbol.section_index + symbol.name.size();
+            }
+        }
+        else if (section->get_type() == SHT_RELA)
+        {
+            const ELFIO::relocation_section_accessor relocations(inputElf, section);
+            const auto entries = relocations.get_view<ELFIO::Elf32_Rela>(convertor);
+            for (ELFIO::Elf_Xword idx = 0; idx < entries.size(); ++idx)
+            {
+                const auto [offset, symbol, type, addend] = entries[idx];
+                sum += offset + symbol + type + static_cast<u64>(addend);
+            }
+        }
+    }
+    return sum;
+}
+
+// Milliseconds per pass of `read` over the tables
+template <typename Reader>
+double timeReader(const Reader& read, int passes, u64& sum)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < passes; ++pass)
+    {
+        sum = read();
+    }
+    const std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count() / passes;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::printf("Usage: %s <input.elf> [passes]\n", argv[0]);
+        return 1;
+    }
+
+    const int passes = argc > 2 ? std::max(1, std::atoi(argv[2])) : 20;
+
+    ELFIO::elfio inputElf;
+    if (!inputElf.load(argv[1]))
+    {
+        std::printf("Error! Unable to load %s\n", argv[1]);
+        return 1;
+    }
+
+    if (inputElf.get_class() != ELFCLASS32 || inputElf.get_encoding() != ELFDATA2MSB)
+    {
+        std::printf("Error! %s is not a 32-bit big-endian ELF\n", argv[1]);
+        return 1;
+    }
+
+    // Warm up the caches before timing any reader
+    readAccessors(inputElf);
+
+    u64 accessorSum = 0;
+    u64 genericSum = 0;
+    u64 fixedSum = 0;
+    const auto accessors =
+        timeReader([&]() { return readAccessors(inputElf); }, passes, accessorSum);
+    const auto generic = timeReader(
+        [&]() { return readViews(inputElf, inputElf.get_convertor()); }, passes, genericSum);
+    const auto fixed = timeReader(
+        [&]() {
+            return readViews(inputElf, ELFIO::fixed_endianess_convertor<ELFDATA2MSB>());
+        },
+        passes, fixedSum);
+
+    if (genericSum != accessorSum || fixedSum != accessorSum)
+    {
+        std::printf("Error! The readers disagree: %llx, %llx, %llx\n",
+                    static_cast<unsigned long long>(accessorSum),
+                    static_cast<unsigned long long>(genericSum),
+                    static_cast<unsigned long long>(fixedSum));
+        return 1;
+    }
+
+    // Speedups are relative to the accessors
+    std::printf("%-36s %10.3f ms\n", "Accessors (get_symbol, get_entry)", accessors);
+    std::printf("%-36s %10.3f ms %8.2fx\n", "View, run-time byte order", generic,
+                accessors / generic);
+    std::printf("%-36s %10.3f ms %8.2fx\n", "View, fixed byte order", fixed, accessors / fixed);
+    return 0;
+}
@@ -1,82 +1,253 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
 #include <deque>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <iostream>
-#include <tuple>
-
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <string_view>
+#include <unordered_map>
+
+#include "BulkEncoder.h"
+#include "ConversionCache.h"
+#include "ConversionStats.h"
+#include "ExportList.h"
 #include "FileWriter.h"
+#include "Parallel.h"
 #include "RSO.h"
+#include "RadixSort.h"
+#include "SectionTable.h"
+#include "SymbolInternTable.h"
+#include "SymbolMap.h"
 #include "elfio/elfio.hpp"
 #include "optparser.h"
 
 namespace fs = std::filesystem;
 
-void writeModuleHeader(FileWriter& writer, RSOHeader& header)
+void writeModuleHeader(FileWriter& writer, const RSOHeader& header)
+{
+    RSOHeaderRecord record;
+    record.next_module_link = header.next_module_link;
+    record.prev_module_link = header.prev_module_link;
+    record.section_count = header.section_count;
+    record.section_info_offset = header.section_info_offset;
+    record.module_name_offset = header.module_name_offset;
+    record.module_name_size = header.module_name_size;
+    record.module_version = header.module_version;
+    record.bss_size = header.bss_size;
+    record.prolog_section_index = header.prolog_section_index;
+    record.epilog_section_index = header.epilog_section_index;
+    record.unresolved_section_index = header.unresolved_section_index;
+    record.bss_section_index = header.bss_section_index;
+    record.prolog_function_offset = header.prolog_function_offset;
+    record.epilog_function_offset = header.epilog_function_offset;
+    record.unresolved_function_offset = header.unresolved_function_offset;
+    record.internal_relocation_table_offset = header.internal_relocation_table_offset;
+    record.internal_relocation_table_size = header.internal_relocation_table_size;
+    record.external_relocation_table_offset = header.external_relocation_table_offset;
+    record.external_relocation_table_size = header.external_relocation_table_size;
+    record.export_symbol_table_offset = header.export_symbol_table_offset;
+    record.export_symbol_table_size = header.export_symbol_table_size;
+    record.export_symbol_names_offset = header.export_symbol_names_offset;
+    record.import_symbol_table_offset = header.import_symbol_table_offset;
+    record.import_symbol_table_size = header.import_symbol_table_size;
+    record.import_symbol_names_offset = header.import_symbol_names_offset;
+
+    writer.write(reinterpret_cast<const char*>(&record), sizeof(record));
+}
+
+// The tables below are encoded straight into the output buffer with the field offsets of their
+// record type. They don't depend on each other, so they can be written concurrently
+
+void writeSectionInfoTable(u8* table, const std::vector<RSOSectionInfo>& sections)
+{
+    BulkEncoder::encodeRecords<RSOSectionInfoRecord>(
+        table, sections.size(), [&](u8* record, size_t idx) {
+            BulkEncoder::storeWord(record, offsetof(RSOSectionInfoRecord, offset),
+                                   sections[idx].offset);
+            BulkEncoder::storeWord(record, offsetof(RSOSectionInfoRecord, size),
+                                   sections[idx].size);
+        });
+}
+
+void writeExportTable(u8* table, const std::vector<RSOSymbol>& symbols,
+                      const std::vector<u32>& nameOffsets)
 {
-    writer.writeBE(header.next_module_link);
-    writer.writeBE(header.prev_module_link);
-    writer.writeBE(header.section_count);
-    writer.writeBE(header.section_info_offset);
-    writer.writeBE(header.module_name_offset);
-    writer.writeBE(header.module_name_size);
-    writer.writeBE(header.module_version);
-    writer.writeBE(header.bss_size);
-    writer.writeBE(header.prolog_section_index);
-    writer.writeBE(header.epilog_section_index);
-    writer.writeBE(header.unresolved_section_index);
-    writer.writeBE(header.bss_section_index);
-    writer.writeBE(header.prolog_function_offset);
-    writer.writeBE(header.epilog_function_offset);
-    writer.writeBE(header.unresolved_function_offset);
-    writer.writeBE(header.internal_relocation_table_offset);
-    writer.writeBE(header.internal_relocation_table_size);
-    writer.writeBE(header.external_relocation_table_offset);
-    writer.writeBE(header.external_relocation_table_size);
-    writer.writeBE(header.export_symbol_table_offset);
-    writer.writeBE(header.export_symbol_table_size);
-    writer.writeBE(header.export_symbol_names_offset);
-    writer.writeBE(header.import_symbol_table_offset);
-    writer.writeBE(header.import_symbol_table_size);
-    writer.writeBE(header.import_symbol_names_offset);
+    BulkEncoder::encodeRecords<RSOExportRecord>(
+        table, symbols.size(), [&](u8* record, size_t idx) {
+            const auto& symbol = symbols[idx];
+            BulkEncoder::storeWord(record, offsetof(RSOExportRecord, name_offset),
+                                   nameOffsets[idx]);
+            BulkEncoder::storeWord(record, offsetof(RSOExportRecord, offset),
+                                   symbol.sectionRelativeOffset);
+            BulkEncoder::storeWord(record, offsetof(RSOExportRecord, section_index),
+                                   symbol.sectionIndex);
+            // Swapped beforehand, so it ends up in host order
+            BulkEncoder::storeWord(record, offsetof(RSOExportRecord, hash),
+                                   Common::swap32(symbol.hash));
+        });
 }
 
-void writeSectionInfo(FileWriter& writer, u32 offset, u32 size)
+void writeImportTable(u8* table, const std::vector<u32>& nameOffsets,
+                      const std::vector<u32>& relocationOffsets)
 {
-    writer.writeBE(offset);
-    writer.writeBE(size);
+    BulkEncoder::encodeRecords<RSOImportRecord>(
+        table, nameOffsets.size(), [&](u8* record, size_t idx) {
+            BulkEncoder::storeWord(record, offsetof(RSOImportRecord, name_offset),
+                                   nameOffsets[idx]);
+            BulkEncoder::storeWord(record, offsetof(RSOImportRecord, offset), 0);
+            BulkEncoder::storeWord(record, offsetof(RSOImportRecord, first_relocation_offset),
+                                   relocationOffsets[idx]);
+        });
 }
 
-void writeExportSymbol(FileWriter& writer, u32 nameOffset, u32 offset, u32 sectionIndex, u32 hash)
+// The symbol is the target section index of internal relocations and the import index of external
+// ones
+void writeRelocationTable(u8* table, const RSORelocationTable& relocations,
+                          const std::vector<RSOSectionInfo>& sections)
 {
-    writer.writeBE(nameOffset);
-    writer.writeBE(offset);
-    writer.writeBE(sectionIndex);
-    writer.write(hash);
+    BulkEncoder::encodeRecords<RSORelocationRecord>(
+        table, relocations.size(), [&](u8* record, size_t idx) {
+            // Convert the relocation offset from being section relative to file relative
+            BulkEncoder::storeWord(record, offsetof(RSORelocationRecord, offset),
+                                   sections[relocations.section[idx]].offset +
+                                       relocations.offset[idx]);
+            BulkEncoder::storeWord(record, offsetof(RSORelocationRecord, info),
+                                   (relocations.symbol[idx] << 8) | relocations.type[idx]);
+            BulkEncoder::storeWord(record, offsetof(RSORelocationRecord, addend),
+                                   relocations.addend[idx]);
+        });
 }
 
-void writeImportSymbol(FileWriter& writer, u32 nameOffset, u32 relOffset)
+constexpr size_t cModuleHeaderSize = sizeof(RSOHeaderRecord);
+
+// Round `position` up to a multiple of `alignment`, which must be a power of two. An alignment of
+// 0 leaves the position as is
+size_t alignPosition(size_t position, size_t alignment)
 {
-    writer.writeBE(nameOffset);
-    writer.write(0);
-    writer.writeBE(relOffset);
+    if (alignment == 0)
+    {
+        return position;
+    }
+
+    return (position + alignment - 1U) & ~(alignment - 1U);
+}
+
+// Place the section info table and the section data after the header. Sections without data in
+// the file (bss, skipped or empty sections) get an offset of 0. Returns the end of the section data
+size_t layoutSections(ELFIO::elfio& inputElf, const SectionTable& sectionTable, RSOHeader& header,
+                      std::vector<RSOSectionInfo>& rsoSections)
+{
+    header.section_info_offset = cModuleHeaderSize;
+    header.section_count = inputElf.sections.size();
+    header.bss_size = 0;
+
+    auto position = header.section_info_offset + inputElf.sections.size() * 8;
+    rsoSections.clear();
+    for (const auto& section : inputElf.sections)
+    {
+        const auto size = static_cast<u32>(section->get_size());
+        if (!sectionTable.isModuleSection(section->get_index()) || size == 0)
+        {
+            rsoSections.emplace_back(RSOSectionInfo{0, 0});
+            continue;
+        }
+
+        if (section->get_type() == SHT_NOBITS)
+        {
+            header.bss_size += size;
+            rsoSections.emplace_back(RSOSectionInfo{0, size});
+            continue;
+        }
+
+        position = alignPosition(position, static_cast<size_t>(section->get_addr_align()));
+        rsoSections.emplace_back(RSOSectionInfo{static_cast<u32>(position), size});
+        position += size;
+    }
+
+    return position;
 }
 
-void writeRelocation(FileWriter& writer, u32 offset, u32 symbol_id, u8 relocation_type, u32 addend)
+// Place the symbol tables, their names and the relocation tables after `position`. The table
+// sizes must be set in the header. Returns the size of the file
+size_t layoutTables(RSOHeader& header, size_t position, size_t exportNamesSize,
+                    size_t importNamesSize)
 {
-    writer.writeBE(offset);
+    const auto place = [&](u32& offset, size_t size) {
+        position = alignPosition(position, 4);
+        offset = static_cast<u32>(position);
+        position += size;
+    };
 
-    writer.writeBE(symbol_id << 8);
-    writer.seek(writer.position() - 1);
-    writer.writeBE(relocation_type);
+    place(header.export_symbol_table_offset, header.export_symbol_table_size);
+    place(header.export_symbol_names_offset, exportNamesSize);
+    place(header.external_relocation_table_offset, header.external_relocation_table_size);
+    place(header.import_symbol_table_offset, header.import_symbol_table_size);
+    place(header.import_symbol_names_offset, importNamesSize);
+    place(header.internal_relocation_table_offset, header.internal_relocation_table_size);
 
-    writer.writeBE(addend);
+    return alignPosition(position, 32);
 }
 
-// @Source: PistonMiner's elf2rel
-const std::vector<std::string> cRelSectionMask = {".init",   ".text", ".ctors", ".dtors",
-                                                  ".rodata", ".data", ".bss"};
+// Value written over the section data once it's in the file
+struct SectionPatch
+{
+    size_t fileOffset;
+    u32 value;
+    u8 size;
+};
+
+void applySectionPatches(FileWriter& writer, const std::vector<SectionPatch>& patches)
+{
+    for (const auto& patch : patches)
+    {
+        if (patch.size == 2)
+        {
+            writer.patchBE(patch.fileOffset, static_cast<u16>(patch.value));
+        }
+        else
+        {
+            writer.patchBE(patch.fileOffset, patch.value);
+        }
+    }
+}
+
+// Amount of relocation entries processed by a single task
+constexpr ELFIO::Elf_Xword cRelocationChunkSize = 0x8000;
+
+// Messages produced while converting a single module. They are buffered so modules converted in
+// parallel don't interleave their output
+class ConversionLog
+{
+  private:
+    std::string text;
+
+  public:
+    template <typename... Args>
+    void print(const char* format, Args... args)
+    {
+        const auto size = std::snprintf(nullptr, 0, format, args...);
+        if (size <= 0)
+        {
+            return;
+        }
+
+        const auto start = text.size();
+        text.resize(start + size + 1);
+        std::snprintf(&text[start], size + 1, format, args...);
+        text.resize(start + size);
+    }
+
+    const std::string& str() const { return text; }
+};
 
-u32 getHash(std::string& symbol)
+u32 getHash(std::string_view symbol)
 {
     u32 hash = 0;
     for (const auto& chr : symbol)
@@ -92,9 +263,33 @@ u32 getHash(std::string& symbol)
     return hash;
 }
 
-std::vector<std::string> readExportFile(fs::path input)
+// Null terminated names of a symbol table, in order, to be written with a single copy. The offset of
+// every name inside the pool is stored in `nameOffsets`
+std::string buildNamePool(const std::vector<RSOSymbol>& symbolTable, std::vector<u32>& nameOffsets)
 {
-    std::vector<std::string> result;
+    size_t poolSize = 0;
+    for (const auto& symbol : symbolTable)
+    {
+        poolSize += symbol.symbol.size() + 1;  // Include `\0`
+    }
+
+    std::string pool;
+    pool.reserve(poolSize);
+    nameOffsets.clear();
+    nameOffsets.reserve(symbolTable.size());
+    for (const auto& symbol : symbolTable)
+    {
+        nameOffsets.emplace_back(static_cast<u32>(pool.size()));
+        pool += symbol.symbol;
+        pool += '\0';
+    }
+
+    return pool;
+}
+
+ExportList readExportFile(fs::path input)
+{
+    ExportList result;
     std::ifstream inputFile(input);
 
     if (inputFile.bad())
@@ -106,299 +301,435 @@ std::vector<std::string> readExportFile(fs::path input)
     std::string line;
     while (std::getline(inputFile, line))
     {
-        result.push_back(line);
+        result.add(line);
     }
 
+    result.compile();
     return result;
 }
 
-int createRSO(fs::path input, ELFIO::elfio& inputElf, fs::path output, bool fullpath,
-              std::unique_ptr<std::vector<std::string>> exportList)
+std::vector<fs::path> readBatchFile(fs::path input)
 {
-    output.replace_extension(".rso");
-
-    FileWriter fileWriter(output);
-
-    // Find symbol section
-    const auto symSectionIt =
-        std::find_if(inputElf.sections.begin(), inputElf.sections.end(),
-                     [](const auto& section) { return section->get_type() == SHT_SYMTAB; });
+    std::vector<fs::path> result;
+    std::ifstream inputFile(input);
 
-    if (symSectionIt == inputElf.sections.begin())
+    if (!inputFile)
     {
-        printf("Error! Unable to find symbol section");
-        return 1;
+        printf("Error! Unable to open the batch file: %s\n", input.string().c_str());
+        exit(1);
     }
 
-    // Symbol accessor
-    ELFIO::symbol_section_accessor symbols(inputElf, *symSectionIt);
+    std::string line;
+    while (std::getline(inputFile, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
 
-    // Find prolog, epilog and unresolved
-    // @Source: PistonMiner's elf2rel
-    auto findSymbolSectionAndOffset = [&](const std::string& name, u8& sectionIndex, u32& offset) {
-        ELFIO::Elf64_Addr addr;
-        ELFIO::Elf_Xword size;
-        unsigned char bind;
-        unsigned char type;
-        ELFIO::Elf_Half section_index;
-        unsigned char other;
-        std::string symbolName;
-        for (int i = 0; i < symbols.get_symbols_num(); ++i)
-        {
-            if (symbols.get_symbol(static_cast<ELFIO::Elf_Xword>(i), symbolName, addr, size, bind,
-                                   type, section_index, other))
-            {
-                if (symbolName == name)
-                {
-                    sectionIndex = static_cast<u8>(section_index);
-                    offset = static_cast<u32>(addr);
-                    break;
-                }
-            }
+        if (!line.empty())
+        {
+            result.emplace_back(line);
         }
-    };
+    }
 
-    RSOHeader header{};
-    header.module_version = 1;
+    return result;
+}
 
-    findSymbolSectionAndOffset("_prolog", header.prolog_section_index,
-                               header.prolog_function_offset);
-    findSymbolSectionAndOffset("_epilog", header.epilog_section_index,
-                               header.epilog_function_offset);
-    findSymbolSectionAndOffset("_unresolved", header.unresolved_section_index,
-                               header.unresolved_function_offset);
+// Value of the instruction/data at `target` once an absolute relocation to `address` is applied.
+// The relocations relative to the module position can't be resolved before it's loaded, so they
+// return false
+bool applyAbsoluteRelocation(u32 type, u32 address, const u8* target, u32& value, u8& size)
+{
+    switch (type)
+    {
+    case R_PPC_ADDR32:
+        value = address;
+        size = 4;
+        return true;
+    case R_PPC_ADDR24:
+        value = (Common::swap32(target) & 0xfc000003u) | (address & 0x3fffffcu);
+        size = 4;
+        return true;
+    case R_PPC_ADDR16:
+    case R_PPC_ADDR16_LO:
+        value = address & 0xffffu;
+        size = 2;
+        return true;
+    case R_PPC_ADDR16_HI:
+        value = address >> 16;
+        size = 2;
+        return true;
+    case R_PPC_ADDR16_HA:
+        value = (address + 0x8000u) >> 16;
+        size = 2;
+        return true;
+    case R_PPC_ADDR14:
+    case R_PPC_ADDR14_BRTAKEN:
+    case R_PPC_ADDR14_BRNKTAKEN:
+        value = (Common::swap32(target) & 0xffff0003u) | (address & 0xfffcu);
+        size = 4;
+        return true;
+    default:
+        return false;
+    }
+}
 
-    writeModuleHeader(fileWriter, header);
+// Remove identical entries from a relocation table, keeping the first one. Applying the same
+// relocation twice writes the same value, so the copies are no-ops
+size_t removeDuplicatedRelocations(RSORelocationTable& relocations)
+{
+    // Relocation key -> index of the first relocation with that key
+    std::unordered_map<u64, size_t> firstRelocation;
+    firstRelocation.reserve(relocations.size());
 
-    // Write Sections Info Table (Blank)
-    header.section_info_offset = fileWriter.position();
-    header.section_count = inputElf.sections.size();
-    for (const auto& section : inputElf.sections)
+    size_t kept = 0;
+    for (size_t idx = 0; idx < relocations.size(); ++idx)
     {
-        writeSectionInfo(fileWriter, 0, 0);
+        auto key = Hash::combine(relocations.section[idx], relocations.offset[idx]);
+        key = Hash::combine(key, relocations.type[idx]);
+        key = Hash::combine(key, (static_cast<u64>(relocations.symbol[idx]) << 32) |
+                                     relocations.addend[idx]);
+
+        const auto [it, inserted] = firstRelocation.emplace(key, kept);
+        if (!inserted && relocations.equal(it->second, idx))
+        {
+            continue;
+        }
+
+        relocations.move(idx, kept++);
     }
 
-    std::vector<RSOSectionInfo> rsoSections;
-    auto totalBssSize = 0u;
-    for (const auto& section : inputElf.sections)
-    {
-        const auto sectionName = section->get_name();
-        const auto fromValidSection = std::find_if(cRelSectionMask.begin(), cRelSectionMask.end(),
-                                                   [&](const std::string& val) {
-                                                       return sectionName == val;
-                                                   }) != cRelSectionMask.end();
+    const auto removed = relocations.size() - kept;
+    relocations.resize(kept);
+    return removed;
+}
 
-        const auto size = static_cast<u32>(section->get_size());
-        if (!fromValidSection || size == 0)
+// Remove the relocations that don't need the loader:
+// * Branches (REL24/REL14) to the same section they are in. The distance to the target doesn't
+//   change wherever the section is loaded, so the branch is written to the section data now.
+// * Duplicated entries.
+// Absolute relocations (e.g. ADDR16_HA/ADDR16_LO pairs) depend on the address of the section, so
+// they are always kept. The resolved branches are added to `patches`. Returns the amount of
+// relocations removed.
+size_t compactRelocations(ELFIO::elfio& inputElf, const std::vector<RSOSectionInfo>& rsoSections,
+                          std::vector<SectionPatch>& patches,
+                          RSORelocationTable& internalRelocations,
+                          RSORelocationTable& externalRelocations)
+{
+    size_t kept = 0;
+    for (size_t idx = 0; idx < internalRelocations.size(); ++idx)
+    {
+        const auto type = internalRelocations.type[idx];
+        const auto sectionIndex = internalRelocations.section[idx];
+        const auto offset = internalRelocations.offset[idx];
+        const auto isBranch = type == R_PPC_REL24 || type == R_PPC_REL14;
+        const auto& fileSection = rsoSections[sectionIndex];
+        const auto& section = inputElf.sections[sectionIndex];
+        if (!isBranch || internalRelocations.symbol[idx] != sectionIndex ||
+            fileSection.offset == 0 || offset + 4 > section->get_size())
         {
-            rsoSections.emplace_back(RSOSectionInfo{0, 0});
+            internalRelocations.move(idx, kept++);
             continue;
         }
 
-        if (section->get_type() == SHT_NOBITS)
+        // For internal relocations the addend is the target offset inside its section
+        const auto distance =
+            static_cast<s64>(internalRelocations.addend[idx]) - static_cast<s64>(offset);
+        const auto range = type == R_PPC_REL24 ? 0x2000000 : 0x8000;
+        if (distance < -range || distance >= range || (distance & 3) != 0)
         {
-            totalBssSize += size;
-            rsoSections.emplace_back(RSOSectionInfo{0, size});
+            internalRelocations.move(idx, kept++);
             continue;
         }
 
-        fileWriter.padToAlignment(static_cast<size_t>(section->get_addr_align()));
+        const auto mask = type == R_PPC_REL24 ? 0x3fffffcu : 0xfffcu;
+        const auto instruction =
+            Common::swap32(reinterpret_cast<const u8*>(section->get_data() + offset));
+        const auto branch = (instruction & ~mask) | (static_cast<u32>(distance) & mask);
+        patches.push_back({static_cast<size_t>(fileSection.offset + offset), branch, 4});
+    }
 
-        const auto offset = static_cast<u32>(fileWriter.position());
+    auto removed = internalRelocations.size() - kept;
+    internalRelocations.resize(kept);
 
-        fileWriter.write(section->get_data(), size);
-        rsoSections.emplace_back(RSOSectionInfo{offset, size});
-    }
+    removed += removeDuplicatedRelocations(internalRelocations);
+    removed += removeDuplicatedRelocations(externalRelocations);
+    return removed;
+}
 
-    header.bss_size = totalBssSize;
+// `convertor` reads the ELF tables, either ELFIO::endianess_convertor or a convertor fixed at
+// compile time for the byte order of the input
+template <typename Convertor>
+int createRSO(fs::path input, ELFIO::elfio& inputElf, fs::path output, bool fullpath,
+              const ExportList* exportList, SymbolInternTable* importedSymbols,
+              const SymbolMap* symbolMap, bool compact, bool groupRelocations, unsigned jobs,
+              const Convertor& convertor, ConversionLog& log, ConversionStats& stats)
+{
+    output.replace_extension(".rso");
 
-    // Save the position
-    fileWriter.padToAlignment(4);
-    header.module_name_offset = static_cast<u32>(fileWriter.position());
+    stats.phase("Special symbols");
 
-    // Rewind and write the correct section infos
-    fileWriter.seek(header.section_info_offset);
+    // Find symbol section
+    const auto symSectionIt =
+        std::find_if(inputElf.sections.begin(), inputElf.sections.end(),
+                     [](const auto& section) { return section->get_type() == SHT_SYMTAB; });
 
-    for (const auto& section : rsoSections)
+    if (symSectionIt == inputElf.sections.begin())
     {
-        writeSectionInfo(fileWriter, section.offset, section.size);
+        log.print("Error! Unable to find symbol section\n");
+        return 1;
     }
 
-    // Go back
-    fileWriter.seek(static_cast<size_t>(header.module_name_offset));
+    // Symbol accessor
+    ELFIO::symbol_section_accessor symbols(inputElf, *symSectionIt);
+    const auto elfSymbols = symbols.get_view<ELFIO::Elf32_Sym>(convertor);
 
-    // Write Module Name
-    if (!fullpath)
+    RSOHeader header{};
+    header.module_version = 1;
+
+    // Find prolog, epilog and unresolved
+    // @Source: PistonMiner's elf2rel
+    struct SpecialSymbol
     {
-        std::string name = input.filename().string();
-        header.module_name_size = name.size();
-        fileWriter.writeString(name);
-    }
-    else
+        const char* name;
+        u8& sectionIndex;
+        u32& offset;
+        bool resolved;
+    };
+
+    std::array<SpecialSymbol, 3> specialSymbols = {{
+        {"_prolog", header.prolog_section_index, header.prolog_function_offset, false},
+        {"_epilog", header.epilog_section_index, header.epilog_function_offset, false},
+        {"_unresolved", header.unresolved_section_index, header.unresolved_function_offset, false},
+    }};
+
+    // The `.hash` section resolves them right away. Otherwise the first symbol with each name is
+    // picked up by the symbol collection pass
+    if (symbols.has_hash_table())
     {
-        std::string name = fs::absolute(input).string();
-        header.module_name_size = name.size();
-        fileWriter.writeString(name);
+        for (auto& special : specialSymbols)
+        {
+            ELFIO::Elf64_Addr addr;
+            ELFIO::Elf_Xword size;
+            unsigned char bind;
+            unsigned char type;
+            ELFIO::Elf_Half sectionIndex;
+            unsigned char other;
+            if (symbols.get_symbol(special.name, addr, size, bind, type, sectionIndex, other))
+            {
+                special.sectionIndex = static_cast<u8>(sectionIndex);
+                special.offset = static_cast<u32>(addr);
+            }
+            special.resolved = true;
+        }
     }
 
+    // Every offset is known before anything is written. The sections go first, their offsets are
+    // needed by the relocations
+    stats.phase("Section layout");
+    std::vector<RSOSectionInfo> rsoSections;
+    const SectionTable sectionTable(inputElf);
+    const auto sectionDataEnd = layoutSections(inputElf, sectionTable, header, rsoSections);
+    stats.count("Section data bytes",
+                sectionDataEnd - header.section_info_offset - rsoSections.size() * 8);
+
+    const auto moduleName =
+        fullpath ? fs::absolute(input).string() : input.filename().string();
+    header.module_name_offset = static_cast<u32>(alignPosition(sectionDataEnd, 4));
+    header.module_name_size = moduleName.size();
+
+    // Symbol names are views into the ELF string table
     std::vector<RSOSymbol> internalSymbolTable;
     std::vector<RSOSymbol> externalSymbolTable;
 
+    // ELF symbol index -> position inside the external symbol table (-1 if absent)
+    std::vector<s32> externalSymbolIndex(elfSymbols.size(), -1);
+
     // Collect all the symbol exported/imported
+    stats.phase("Symbol collection");
+    for (auto it = elfSymbols.begin(); it != elfSymbols.end(); ++it)
     {
-        ELFIO::Elf64_Addr addr;
-        ELFIO::Elf_Xword size;
-        unsigned char bind;
-        unsigned char type;
-        ELFIO::Elf_Half sectionIndex;
-        unsigned char other;
-        std::string symbolName;
-        for (auto i = 0u; i < symbols.get_symbols_num(); ++i)
-        {
-            if (!symbols.get_symbol(static_cast<ELFIO::Elf_Xword>(i), symbolName, addr, size, bind,
-                                    type, sectionIndex, other))
-            {
-                continue;
-            }
+        const auto symbol = *it;
+        if (symbol.name.empty())
+        {
+            continue;
+        }
 
-            if (symbolName.empty())
+        for (auto& special : specialSymbols)
+        {
+            if (!special.resolved && symbol.name == special.name)
             {
-                continue;
+                special.sectionIndex = static_cast<u8>(symbol.section_index);
+                special.offset = static_cast<u32>(symbol.value);
+                special.resolved = true;
             }
+        }
 
-            // Symbol to export?
-            if (bind != STB_LOCAL && sectionIndex != 0)
+        // Symbol to export?
+        if (symbol.bind != STB_LOCAL && symbol.section_index != 0)
+        {
+            if (exportList)
             {
-                if (exportList)
+                if (!exportList->contains(symbol.name))
                 {
-                    const auto it = std::find(exportList->begin(), exportList->end(), symbolName);
-                    if (it == exportList->end())
-                    {
-                        // Symbol not found in the export list so skip the symbol
-                        continue;
-                    }
+                    // Symbol not found in the export list so skip the symbol
+                    continue;
                 }
+            }
 
-                const auto hash = getHash(symbolName);
-                internalSymbolTable.emplace_back(
-                    RSOSymbol{hash, symbolName, sectionIndex, static_cast<u32>(addr)});
+            const auto hash = getHash(symbol.name);
+            internalSymbolTable.emplace_back(RSOSymbol{hash, symbol.name, symbol.section_index,
+                                                       static_cast<u32>(symbol.value)});
 
-                continue;
-            }
+            continue;
+        }
 
-            // External/Imported Symbol
-            if (sectionIndex == 0)
-            {
-                const auto hash = getHash(symbolName);
-                externalSymbolTable.emplace_back(
-                    RSOSymbol{hash, symbolName, sectionIndex, static_cast<u32>(addr)});
+        // External/Imported Symbol
+        if (symbol.section_index == 0)
+        {
+            const auto hash = getHash(symbol.name);
+            externalSymbolIndex[it.get_index()] = static_cast<s32>(externalSymbolTable.size());
+            externalSymbolTable.emplace_back(RSOSymbol{hash, symbol.name, symbol.section_index,
+                                                       static_cast<u32>(symbol.value)});
 
-                continue;
-            }
+            continue;
         }
     }
 
-    const auto tryGetSymbol = [](const std::vector<RSOSymbol>& symbolTable,
-                                 std::string& symbolName) {
-        const auto hash = getHash(symbolName);
-        const auto it = std::find_if(symbolTable.begin(), symbolTable.end(),
-                                     [&hash](const RSOSymbol& p) { return p.hash == hash; });
-
-        if (it != symbolTable.end())
+    // Share the imports with the static module converted after this one
+    if (importedSymbols)
+    {
+        for (const auto& externalSymbol : externalSymbolTable)
         {
-            return std::make_tuple(static_cast<s32>(it - symbolTable.begin()), hash);
+            importedSymbols->intern(externalSymbol.symbol);
         }
+    }
 
-        return std::make_tuple(static_cast<s32>(-1), hash);
-    };
+    // Relocation sections are split in chunks of entries that are processed in parallel, each chunk
+    // into its own vectors. Chunks are merged back in order so the output doesn't depend on the
+    // amount of threads
+    struct RelocationChunk
+    {
+        ELFIO::section* section;
+        ELFIO::Elf_Xword begin;
+        ELFIO::Elf_Xword end;
 
-    std::vector<RSORelocation> internalRelocations;
-    std::vector<RSORelocation> externalRelocations;
+        RSORelocationTable internalRelocations;
+        RSORelocationTable externalRelocations;
 
-    // Acumulate Relocations
+        std::vector<SectionPatch> patches;
+        size_t prelinkedRelocations = 0;
+
+        ConversionLog log;
+        int result = 0;
+    };
+
+    std::vector<RelocationChunk> relocationChunks;
     for (const auto& section : inputElf.sections)
     {
-        const auto sectionName = section->get_name();
-
-        // Check if it's a relocation section
-        if (sectionName.compare(0, 5, ".rela") != 0)
+        // Only the relocations of the sections copied to the module, read as Elf32_Rela
+        if (!sectionTable.isModuleRelocation(section->get_index()) ||
+            section->get_type() != SHT_RELA)
         {
             continue;
         }
 
-        // Check if the relocation section is from a usable section
-        const auto fromValidSection =
-            std::find_if(cRelSectionMask.begin(), cRelSectionMask.end(),
-                         [&](const std::string& val) {
-                             return sectionName.compare(5, val.size(), val.c_str()) == 0;
-                         }) != cRelSectionMask.end();
+        // Make sure the section data is loaded before it's shared between threads
+        section->get_data();
+        if (const auto targetSection = inputElf.sections[section->get_info()])
+        {
+            targetSection->get_data();
+        }
 
-        if (!fromValidSection)
+        ELFIO::relocation_section_accessor relocations(inputElf, section);
+        const auto entriesCount = relocations.get_entries_num();
+        for (ELFIO::Elf_Xword begin = 0; begin < entriesCount; begin += cRelocationChunkSize)
         {
-            continue;
+            RelocationChunk chunk;
+            chunk.section = section;
+            chunk.begin = begin;
+            chunk.end = std::min(begin + cRelocationChunkSize, entriesCount);
+            relocationChunks.emplace_back(std::move(chunk));
         }
+    }
 
-        const auto relocationSectionIndex = section->get_info();
+    // Acumulate Relocations
+    stats.phase("Relocation accumulation");
+    parallelFor(relocationChunks.size(), jobs, [&](size_t chunkIdx) {
+        auto& chunk = relocationChunks[chunkIdx];
+        const auto relocationSectionIndex = chunk.section->get_info();
 
-        ELFIO::relocation_section_accessor relocations(inputElf, section);
+        ELFIO::relocation_section_accessor relocations(inputElf, chunk.section);
+        const auto entries = relocations.get_view<ELFIO::Elf32_Rela>(convertor);
 
-        for (auto i = 0u; i < relocations.get_entries_num(); ++i)
+        for (auto i = chunk.begin; i < chunk.end; ++i)
         {
-            ELFIO::Elf64_Addr offset;
-            ELFIO::Elf_Word symbol;
-            ELFIO::Elf_Word type;
-            ELFIO::Elf_Sxword addend;
-            relocations.get_entry(i, offset, symbol, type, addend);
+            const auto [offset, symbol, type, addend] = entries[i];
 
             if (type == R_PPC_NONE)
                 continue;
 
-            ELFIO::Elf_Xword size;
-            unsigned char bind;
-            unsigned char symbolType;
-            ELFIO::Elf_Half sectionIndex;
-            unsigned char other;
-            std::string symbolName;
-            ELFIO::Elf64_Addr symbolValue;
-            if (!symbols.get_symbol(symbol, symbolName, symbolValue, size, bind, symbolType,
-                                    sectionIndex, other))
+            if (symbol >= elfSymbols.size())
+            {
+                chunk.log.print("Error! Unable to find symbol %u in symbol table!\n",
+                                static_cast<uint32_t>(symbol));
+                chunk.result = 1;
+                return;
+            }
+
+            const auto symbolEntry = elfSymbols[symbol];
+            const auto sectionIndex = symbolEntry.section_index;
+            const auto symbolValue = symbolEntry.value;
+
+            // Resolve now the imports with a known address, when the relocation doesn't depend on
+            // where the module is loaded
+            u32 address;
+            if (sectionIndex == 0 && symbolMap && symbolMap->find(symbolEntry.name, address))
             {
-                printf("Error! Unable to find symbol %u in symbol table!\n",
-                       static_cast<uint32_t>(symbol));
-                return 1;
+                const auto& targetSection = inputElf.sections[relocationSectionIndex];
+                const auto& fileSection = rsoSections[relocationSectionIndex];
+                u32 value;
+                u8 size;
+                if (fileSection.offset != 0 && offset + 4 <= targetSection->get_size() &&
+                    applyAbsoluteRelocation(
+                        type, address + static_cast<u32>(addend),
+                        reinterpret_cast<const u8*>(targetSection->get_data() + offset), value,
+                        size))
+                {
+                    const auto fileOffset = static_cast<size_t>(fileSection.offset + offset);
+                    chunk.patches.push_back({fileOffset, value, size});
+                    ++chunk.prelinkedRelocations;
+                    continue;
+                }
             }
 
-            RSORelocation rel;
-            rel.section = relocationSectionIndex;
-            rel.offset = static_cast<uint32_t>(offset);
-            rel.type = type;
-            rel.targetSection = static_cast<uint8_t>(sectionIndex);
             if (sectionIndex == 0)
             {
                 // External Relocation
-                auto [symbolIndex, hash] = tryGetSymbol(externalSymbolTable, symbolName);
+                const auto symbolIndex =
+                    symbol < externalSymbolIndex.size() ? externalSymbolIndex[symbol] : -1;
                 if (symbolIndex == -1)
                 {
                     // This can't happen because the external relocation have a reference to the
                     // symbol index in the import table
-                    printf("Internal Error! Unable to find relocation symbol. Please contact "
-                           "developer.\n");
-                    return 2;
+                    chunk.log.print("Internal Error! Unable to find relocation symbol. Please "
+                                    "contact developer.\n");
+                    chunk.result = 2;
+                    return;
                 }
 
-                rel.symbolHash = hash;
-                rel.symbolIndex = static_cast<u32>(symbolIndex);
-                rel.addend = 0;
-                externalRelocations.emplace_back(rel);
+                chunk.externalRelocations.push(static_cast<u16>(relocationSectionIndex),
+                                               static_cast<u32>(offset), static_cast<u8>(type),
+                                               static_cast<u32>(symbolIndex), 0);
             }
             else
             {
-                // Internal Relocation
-                auto [symbolIndex, hash] = tryGetSymbol(internalSymbolTable, symbolName);
-                rel.symbolHash = hash;
-                rel.symbolIndex = static_cast<u32>(symbolIndex);
-                rel.addend = static_cast<uint32_t>(addend + symbolValue);
-                internalRelocations.emplace_back(rel);
+                // Internal Relocation, the symbol is the section of the target
+                chunk.internalRelocations.push(
+                    static_cast<u16>(relocationSectionIndex), static_cast<u32>(offset),
+                    static_cast<u8>(type), static_cast<u8>(sectionIndex),
+                    static_cast<u32>(addend + symbolValue));
             }
 
             // Apply relocation with the `_unresolved` as the symbol, if the module export the function
@@ -411,168 +742,583 @@ int createRSO(fs::path input, ELFIO::elfio& inputElf, fs::path output, bool full
 
                 targetInstruction = Common::swap32(targetInstruction);
                 const auto offsetDifference = static_cast<s64>(header.unresolved_function_offset) - static_cast<s64>(offset);
-                const auto replacementInstruction = Common::swap32((static_cast<u32>(offsetDifference) & 0x3fffffcu) | (targetInstruction & 0xfc000003u));
+                const auto replacementInstruction = (static_cast<u32>(offsetDifference) & 0x3fffffcu) | (targetInstruction & 0xfc000003u);
 
                 const auto& fileSection = rsoSections[relocationSectionIndex];
-                const auto currentPosition = fileWriter.position();
-
                 const auto fileOffset = static_cast<size_t>(fileSection.offset + offset);
-                fileWriter.seek(fileOffset);
-                fileWriter.write(replacementInstruction);
-                fileWriter.seek(currentPosition);
+                chunk.patches.push_back({fileOffset, replacementInstruction, 4});
             }
         }
+    });
+
+    // Merge the chunks in order
+    RSORelocationTable internalRelocations;
+    RSORelocationTable externalRelocations;
+    std::vector<SectionPatch> sectionPatches;
+    size_t prelinkedRelocations = 0;
+    {
+        size_t internalCount = 0;
+        size_t externalCount = 0;
+        for (const auto& chunk : relocationChunks)
+        {
+            if (chunk.result != 0)
+            {
+                log.print("%s", chunk.log.str().c_str());
+                return chunk.result;
+            }
+
+            internalCount += chunk.internalRelocations.size();
+            externalCount += chunk.externalRelocations.size();
+        }
+
+        internalRelocations.reserve(internalCount);
+        externalRelocations.reserve(externalCount);
+        for (auto& chunk : relocationChunks)
+        {
+            internalRelocations.append(chunk.internalRelocations);
+            externalRelocations.append(chunk.externalRelocations);
+
+            sectionPatches.insert(sectionPatches.end(), chunk.patches.begin(),
+                                  chunk.patches.end());
+
+            prelinkedRelocations += chunk.prelinkedRelocations;
+        }
+
+        relocationChunks.clear();
+    }
+
+    size_t compactedRelocations = 0;
+    if (compact)
+    {
+        stats.phase("Relocation compaction");
+        compactedRelocations = compactRelocations(inputElf, rsoSections, sectionPatches,
+                                                  internalRelocations, externalRelocations);
+        log.print("Compaction removed %zu relocations (%zu bytes)\n", compactedRelocations,
+                  compactedRelocations * 12);
     }
 
-    // Sort External Relocation, by Imported Symbol Index
-    std::sort(externalRelocations.begin(), externalRelocations.end(),
-              [](const RSORelocation& left, const RSORelocation& right) {
-                  return left.symbolIndex > right.symbolIndex;
-              });
+    // Drop the imports fully resolved at build time
+    size_t prelinkedImports = 0;
+    if (symbolMap)
+    {
+        std::vector<u32> relocationCount(externalSymbolTable.size(), 0);
+        for (const auto symbolIndex : externalRelocations.symbol)
+        {
+            ++relocationCount[symbolIndex];
+        }
+
+        std::vector<u32> importRemap(externalSymbolTable.size(), 0);
+        std::vector<RSOSymbol> remainingImports;
+        remainingImports.reserve(externalSymbolTable.size());
+        for (auto idx = 0u; idx < externalSymbolTable.size(); ++idx)
+        {
+            u32 address;
+            if (relocationCount[idx] == 0 &&
+                symbolMap->find(externalSymbolTable[idx].symbol, address))
+            {
+                ++prelinkedImports;
+                continue;
+            }
+
+            importRemap[idx] = static_cast<u32>(remainingImports.size());
+            remainingImports.emplace_back(std::move(externalSymbolTable[idx]));
+        }
+
+        for (auto& symbolIndex : externalRelocations.symbol)
+        {
+            symbolIndex = importRemap[symbolIndex];
+        }
+
+        externalSymbolTable = std::move(remainingImports);
+    }
+
+    stats.phase("Sorts");
+    if (groupRelocations)
+    {
+        // Order the relocations by the file offset they patch, grouped by target section (internal)
+        // or by imported symbol (external), so the loader walks the module memory in order
+        const auto sortKey = [&](const RSORelocationTable& relocations, size_t idx) {
+            const auto fileOffset = rsoSections[relocations.section[idx]].offset +
+                                    relocations.offset[idx];
+            return (static_cast<u64>(relocations.symbol[idx]) << 32) | fileOffset;
+        };
+
+        internalRelocations.permute(radixSortOrder(internalRelocations.size(), [&](size_t idx) {
+            return sortKey(internalRelocations, idx);
+        }));
+        externalRelocations.permute(radixSortOrder(externalRelocations.size(), [&](size_t idx) {
+            return sortKey(externalRelocations, idx);
+        }));
+    }
+    else
+    {
+        // Sort External Relocation, by Imported Symbol Index
+        std::vector<u32> order(externalRelocations.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](u32 left, u32 right) {
+            return externalRelocations.symbol[left] > externalRelocations.symbol[right];
+        });
+        externalRelocations.permute(order);
+    }
+
+    // Offset of the first external relocation of every imported symbol
+    std::vector<u32> firstRelocationOffset(externalSymbolTable.size(), 0xffffffff);
+    for (auto idx = 0u; idx < externalRelocations.size(); ++idx)
+    {
+        auto& relOffset = firstRelocationOffset[externalRelocations.symbol[idx]];
+        if (relOffset == 0xffffffff)
+        {
+            relOffset = idx * 12;
+        }
+    }
 
     // Sort Internal Symbol by Hash
     std::sort(internalSymbolTable.begin(), internalSymbolTable.end(),
               [](const RSOSymbol& left, const RSOSymbol& right) { return left.hash > right.hash; });
 
-    // Write Exported Symbol Table
+    // Place the tables after the module name
+    stats.phase("Table layout");
+    std::vector<u32> exportNameOffsets;
+    const auto exportNames = buildNamePool(internalSymbolTable, exportNameOffsets);
+    std::vector<u32> importNameOffsets;
+    const auto importNames = buildNamePool(externalSymbolTable, importNameOffsets);
 
-    // Calculate NameOffset
-    std::vector<u32> symbolNameOffset;
-    auto currentNameOffset = 0u;
-    for (const auto& internalSymbol : internalSymbolTable)
+    header.export_symbol_table_size = internalSymbolTable.size() * 16;
+    header.external_relocation_table_size = externalRelocations.size() * 12;
+    header.import_symbol_table_size = externalSymbolTable.size() * 12;
+    header.internal_relocation_table_size = internalRelocations.size() * 12;
+    const auto fileSize =
+        layoutTables(header, header.module_name_offset + moduleName.size() + 1,
+                     exportNames.size(), importNames.size());
+
+    // Write the header, the section info table and the module name, and record where the section
+    // data is copied from
+    stats.phase("Section data");
+    FileWriter fileWriter(output);
+    writeModuleHeader(fileWriter, header);
+    for (size_t idx = 0; idx < rsoSections.size(); ++idx)
     {
-        symbolNameOffset.emplace_back(currentNameOffset);
-        currentNameOffset += internalSymbol.symbol.size() + 1;  // Include `\0`
+        if (rsoSections[idx].offset == 0)
+        {
+            continue;
+        }
+
+        // The section data is copied file to file when the module is flushed
+        const auto& section = inputElf.sections[idx];
+        fileWriter.seek(rsoSections[idx].offset);
+        fileWriter.copyFrom(input, section->get_offset(), rsoSections[idx].size);
     }
 
-    fileWriter.padToAlignment(4);
-    header.export_symbol_table_offset = fileWriter.position();
-    header.export_symbol_table_size = internalSymbolTable.size() * 16;
-    for (auto idx = 0u; idx < internalSymbolTable.size(); ++idx)
+    fileWriter.seek(header.module_name_offset);
+    fileWriter.writeString(moduleName);
+
+    // The rest of the file is allocated once and every table is encoded in its place
+    stats.phase("Tables");
+    fileWriter.resize(fileSize);
+    const std::array<std::function<void()>, 7> tableWriters = {
+        [&]() {
+            writeSectionInfoTable(fileWriter.data(header.section_info_offset), rsoSections);
+        },
+        [&]() {
+            writeExportTable(fileWriter.data(header.export_symbol_table_offset),
+                             internalSymbolTable, exportNameOffsets);
+        },
+        [&]() {
+            std::memcpy(fileWriter.data(header.export_symbol_names_offset), exportNames.data(),
+                        exportNames.size());
+        },
+        [&]() {
+            writeRelocationTable(fileWriter.data(header.external_relocation_table_offset),
+                                 externalRelocations, rsoSections);
+        },
+        [&]() {
+            writeImportTable(fileWriter.data(header.import_symbol_table_offset),
+                             importNameOffsets, firstRelocationOffset);
+        },
+        [&]() {
+            std::memcpy(fileWriter.data(header.import_symbol_names_offset), importNames.data(),
+                        importNames.size());
+        },
+        [&]() {
+            writeRelocationTable(fileWriter.data(header.internal_relocation_table_offset),
+                                 internalRelocations, rsoSections);
+        },
+    };
+    // The writers run concurrently, so each one is timed on its own and reported as a counter
+    constexpr std::array<const char*, 7> cTableNames = {
+        "Section info table", "Export table", "Export names", "External relocations",
+        "Import table",       "Import names", "Internal relocations",
+    };
+    std::array<u64, 7> tableMicroseconds{};
+    parallelFor(tableWriters.size(), jobs, [&](size_t idx) {
+        const auto start = std::chrono::steady_clock::now();
+        tableWriters[idx]();
+        tableMicroseconds[idx] = static_cast<u64>(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start)
+                .count());
+    });
+
+    // Fix-ups of the section data, on top of the copied bytes
+    stats.phase("Section patches");
+    applySectionPatches(fileWriter, sectionPatches);
+
+    for (size_t idx = 0; idx < tableWriters.size(); ++idx)
     {
-        const auto& internalSymbol = internalSymbolTable[idx];
-        const auto nameOffset = symbolNameOffset[idx];
-        writeExportSymbol(fileWriter, nameOffset, internalSymbol.sectionRelativeOffset,
-                          internalSymbol.sectionIndex, internalSymbol.hash);
+        stats.count(std::string(cTableNames[idx]) + " (us)", tableMicroseconds[idx]);
     }
 
-    // Write Exported Symbol String Table
-    fileWriter.padToAlignment(4);
-    header.export_symbol_names_offset = fileWriter.position();
-    for (const auto& internalSymbol : internalSymbolTable)
+    stats.count("Export names bytes", exportNames.size());
+    stats.count("Import names bytes", importNames.size());
+    stats.count("Exported symbols", internalSymbolTable.size());
+    stats.count("Imported symbols", externalSymbolTable.size());
+    stats.count("Internal relocations", internalRelocations.size());
+    stats.count("External relocations", externalRelocations.size());
+    if (compact)
     {
-        fileWriter.writeString(internalSymbol.symbol);
+        stats.count("Compacted relocations", compactedRelocations);
+        stats.count("Compacted relocation bytes", compactedRelocations * 12);
     }
+    if (symbolMap)
+    {
+        stats.count("Prelinked relocations", prelinkedRelocations);
+        stats.count("Prelinked imports", prelinkedImports);
+    }
+    stats.count("Export table bytes", header.export_symbol_table_size);
+    stats.count("Import table bytes", header.import_symbol_table_size);
+    stats.count("Internal relocation bytes", header.internal_relocation_table_size);
+    stats.count("External relocation bytes", header.external_relocation_table_size);
 
-    // Write External Relocation
-    fileWriter.padToAlignment(4);
-    header.external_relocation_table_offset = fileWriter.position();
-    header.external_relocation_table_size = externalRelocations.size() * 12;
-    for (const auto& relocation : externalRelocations)
+    stats.phase("Output write");
+    if (!fileWriter.flush())
     {
-        const auto section = rsoSections[relocation.section];
+        log.print("Error! Unable to write the output file: %s\n", output.string().c_str());
+        return 1;
+    }
+    stats.endPhase();
 
-        // Convert the relocation offset from being section relative to file relative
-        const auto offset = section.offset + relocation.offset;
+    stats.count("Output bytes", fileWriter.size());
+    return 0;
+}
+
+// The static module (.sel) is the RSO of the main executable. It has no sections nor relocations,
+// only the export table used by the child modules to resolve their imports. Every export uses the
+// section index 0 and the absolute address of the symbol as its offset. When `referencedSymbols`
+// is given, only the symbols imported by the child modules are exported.
+template <typename Convertor>
+int createStaticRSO(fs::path input, ELFIO::elfio& inputElf, fs::path output, bool fullpath,
+                    const ExportList* exportList, const SymbolInternTable* referencedSymbols,
+                    const Convertor& convertor, ConversionLog& log, ConversionStats& stats)
+{
+    output.replace_extension(".sel");
 
-        // Get the symbol index inside the import symbol table
-        const auto& symbolIt =
-            std::find_if(externalSymbolTable.begin(), externalSymbolTable.end(),
-                         [&](const RSOSymbol& p) { return p.hash == relocation.symbolHash; });
+    // Find symbol section
+    const auto symSectionIt =
+        std::find_if(inputElf.sections.begin(), inputElf.sections.end(),
+                     [](const auto& section) { return section->get_type() == SHT_SYMTAB; });
 
-        if (symbolIt == externalSymbolTable.end())
+    if (symSectionIt == inputElf.sections.end())
+    {
+        log.print("Error! Unable to find symbol section\n");
+        return 1;
+    }
+
+    ELFIO::symbol_section_accessor symbols(inputElf, *symSectionIt);
+
+    RSOHeader header{};
+    header.module_version = 1;
+
+    header.section_info_offset = cModuleHeaderSize;
+    header.section_count = 0;
+
+    // The module name follows the header
+    const auto moduleName =
+        fullpath ? fs::absolute(input).string() : input.filename().string();
+    header.module_name_offset = cModuleHeaderSize;
+    header.module_name_size = moduleName.size();
+
+    // Collect every global symbol defined by the executable
+    stats.phase("Symbol collection");
+    std::vector<RSOSymbol> exportSymbolTable;
+    size_t prunedSymbols = 0;
+    for (const auto& symbol : symbols.get_view<ELFIO::Elf32_Sym>(convertor))
+    {
+        if (symbol.name.empty() || symbol.bind == STB_LOCAL ||
+            symbol.section_index == SHN_UNDEF || symbol.type == STT_SECTION ||
+            symbol.type == STT_FILE)
         {
-            // This should be imposible since the hash of the symbol come from a function that add
-            // the symbol to the list
-            printf("Errror! Unable to find symbol for relocation %ull\n", offset);
-            return 1;
+            continue;
         }
 
-        const auto symbolIndex = static_cast<u32>(symbolIt - externalSymbolTable.begin());
-        writeRelocation(fileWriter, offset, symbolIndex, relocation.type, relocation.addend);
+        if (exportList && !exportList->contains(symbol.name))
+        {
+            continue;
+        }
+
+        if (referencedSymbols && !referencedSymbols->contains(symbol.name))
+        {
+            ++prunedSymbols;
+            continue;
+        }
+
+        exportSymbolTable.emplace_back(
+            RSOSymbol{getHash(symbol.name), symbol.name, 0, static_cast<u32>(symbol.value)});
     }
 
-    // Write Imported Symbol Table
+    // Sort Exported Symbol by Hash, same as the dynamic modules. Ties are ordered by name so the
+    // output doesn't depend on the symbol table order, which also leaves duplicated names next to
+    // each other. The sort is stable, so the first definition of a duplicated name is kept
+    stats.phase("Sorts");
+    std::stable_sort(exportSymbolTable.begin(), exportSymbolTable.end(),
+                     [](const RSOSymbol& left, const RSOSymbol& right) {
+                         if (left.hash != right.hash)
+                         {
+                             return left.hash > right.hash;
+                         }
+                         return left.symbol < right.symbol;
+                     });
+
+    exportSymbolTable.erase(std::unique(exportSymbolTable.begin(), exportSymbolTable.end(),
+                                        [](const RSOSymbol& left, const RSOSymbol& right) {
+                                            return left.symbol == right.symbol;
+                                        }),
+                            exportSymbolTable.end());
+
+    // Build the string pool in a single pass. Nothing is imported nor relocated, so every other
+    // table is empty
+    stats.phase("Table layout");
+    std::vector<u32> symbolNameOffset;
+    const auto stringPool = buildNamePool(exportSymbolTable, symbolNameOffset);
 
-    // Calculate name offset
-    symbolNameOffset.clear();
-    currentNameOffset = 0u;
-    for (const auto& externalSymbol : externalSymbolTable)
+    header.export_symbol_table_size = exportSymbolTable.size() * 16;
+    const auto fileSize = layoutTables(header, header.module_name_offset + moduleName.size() + 1,
+                                       stringPool.size(), 0);
+
+    stats.phase("Export table");
+    FileWriter fileWriter(output);
+    writeModuleHeader(fileWriter, header);
+    fileWriter.writeString(moduleName);
+    fileWriter.resize(fileSize);
+
+    writeExportTable(fileWriter.data(header.export_symbol_table_offset), exportSymbolTable,
+                     symbolNameOffset);
+    std::memcpy(fileWriter.data(header.export_symbol_names_offset), stringPool.data(),
+                stringPool.size());
+
+    stats.count("Exported symbols", exportSymbolTable.size());
+    if (referencedSymbols)
     {
-        symbolNameOffset.emplace_back(currentNameOffset);
-        currentNameOffset += externalSymbol.symbol.size() + 1;  // Include `\0`
+        stats.count("Pruned symbols", prunedSymbols);
     }
+    stats.count("Export table bytes", header.export_symbol_table_size);
+    stats.count("Export names bytes", stringPool.size());
 
-    fileWriter.padToAlignment(4);
-    header.import_symbol_table_offset = fileWriter.position();
-    header.import_symbol_table_size = externalSymbolTable.size() * 12;
-
-    for (auto idx = 0u; idx < externalSymbolTable.size(); ++idx)
+    stats.phase("Output write");
+    if (!fileWriter.flush())
     {
-        const auto& externalSymbol = externalSymbolTable[idx];
+        log.print("Error! Unable to write the output file: %s\n", output.string().c_str());
+        return 1;
+    }
+    stats.endPhase();
 
-        const auto nameOffset = symbolNameOffset[idx];
+    stats.count("Output bytes", fileWriter.size());
+    return 0;
+}
+
+// Version of the converter output, part of the conversion cache key. Bump it whenever a change to
+// the converter makes the same input and options produce a different module, so the modules
+// converted by an older build are not reused
+constexpr u64 cOutputVersion = 1;
 
-        // Find first relocation that uses this
-        const auto& relIt = std::find_if(
-            externalRelocations.begin(), externalRelocations.end(),
-            [&](const RSORelocation& rel) { return rel.symbolHash == externalSymbol.hash; });
+// Settings shared by every module converted in this run
+struct ConversionOptions
+{
+    bool fullpath = false;
+    const ExportList* exportList = nullptr;
+    unsigned jobs = 1;
+    ConversionCache* cache = nullptr;
+
+    // Names imported by the dynamic modules of the batch. When set, the static module only exports
+    // these names, so it must be converted after every dynamic module
+    SymbolInternTable* importedSymbols = nullptr;
+
+    // Addresses of the static module symbols, used to resolve imports at build time
+    const SymbolMap* symbolMap = nullptr;
+
+    // Resolve the relocations that don't depend on where the module is loaded
+    bool compactRelocations = false;
+
+    // Order the relocation tables by the offset they patch
+    bool groupRelocations = false;
+
+    enum class StatsFormat
+    {
+        None,
+        Text,
+        Json,
+    } statsFormat = StatsFormat::None;
+
+    // Hash of the settings that change the output, part of the conversion cache key
+    u64 hash = 0;
+};
+
+// Add the names imported by a dynamic module to `importedSymbols`. Only needed when the module
+// isn't converted, otherwise `createRSO` already does it
+void internImportedSymbols(ELFIO::elfio& inputElf, SymbolInternTable& importedSymbols)
+{
+    for (const auto& section : inputElf.sections)
+    {
+        if (section->get_type() != SHT_SYMTAB)
+        {
+            continue;
+        }
 
-        u32 relOffset = 0xffffffff;
-        if (relIt != externalRelocations.end())
+        ELFIO::symbol_section_accessor symbols(inputElf, section);
+        for (const auto& symbol : symbols.get_view<ELFIO::Elf32_Sym>())
         {
-            relOffset = static_cast<u32>(relIt - externalRelocations.begin()) * 12;
+            if (!symbol.name.empty() && symbol.section_index == 0)
+            {
+                importedSymbols.intern(symbol.name);
+            }
         }
+        break;
+    }
+}
 
-        writeImportSymbol(fileWriter, nameOffset, relOffset);
+int convertModule(const fs::path& input, const fs::path& output, const ConversionOptions& options,
+                  ConversionLog& log, ConversionStats& stats)
+{
+    // Load input file. Fallback to lazily reading the sections when the file can't be mapped
+    stats.phase("ELF load");
+    ELFIO::elfio inputElf;
+    if (!inputElf.load_mapped(input.string()) && !inputElf.load(input.string()))
+    {
+        log.print("Failed to load input file\n");
+        return 1;
     }
 
-    // Write Imported Symbol String Table
-    fileWriter.padToAlignment(4);
-    header.import_symbol_names_offset = fileWriter.position();
-    for (const auto& externalSymbol : externalSymbolTable)
+    const auto type = inputElf.get_type();
+    if (type != ET_REL && type != ET_EXEC)
     {
-        fileWriter.writeString(externalSymbol.symbol);
+        log.print("Error! Unsupported binary ELF type: %d\n", type);
+        return 1;
     }
 
-    // Write Internal Relocation Table
-    fileWriter.padToAlignment(4);
-    header.internal_relocation_table_offset = fileWriter.position();
-    header.internal_relocation_table_size = internalRelocations.size() * 12;
-    for (const auto& relocation : internalRelocations)
+    // Modules only hold 32-bit addresses
+    if (inputElf.get_class() != ELFCLASS32)
     {
-        const auto section = rsoSections[relocation.section];
+        log.print("Error! Unsupported binary ELF class: %d\n", inputElf.get_class());
+        return 1;
+    }
 
-        // Convert the relocation offset from being section relative to file relative
-        const auto offset = section.offset + relocation.offset;
+    // Skip the conversion if the previous output was created from the same input and options
+    fs::path modulePath = output;
+    modulePath.replace_extension(type == ET_REL ? ".rso" : ".sel");
 
-        // Get the section index of the symbol being patched to
-        const auto& sectionIndex = relocation.targetSection;
+    u64 cacheKey = 0;
+    if (options.cache)
+    {
+        stats.phase("Cache lookup");
+        const auto moduleName =
+            options.fullpath ? fs::absolute(input).string() : input.filename().string();
+        auto optionsHash = Hash::combine(
+            Hash::combine(options.hash, type), Hash::bytes(moduleName.data(), moduleName.size()));
 
-        writeRelocation(fileWriter, offset, sectionIndex, relocation.type, relocation.addend);
+        if (options.importedSymbols && type == ET_EXEC)
+        {
+            optionsHash = Hash::combine(optionsHash, options.importedSymbols->fingerprint());
+        }
+
+        if (ConversionCache::computeKey(input, optionsHash, cacheKey) &&
+            options.cache->isUpToDate(modulePath, cacheKey))
+        {
+            if (options.importedSymbols && type == ET_REL)
+            {
+                internImportedSymbols(inputElf, *options.importedSymbols);
+            }
+
+            stats.endPhase();
+            log.print("Output is up to date: %s\n", modulePath.string().c_str());
+            return 0;
+        }
     }
 
-    fileWriter.padToAlignment(32);
-    fileWriter.seek(0);
-    writeModuleHeader(fileWriter, header);
+    const auto convert = [&](const auto& convertor) {
+        return type == ET_REL
+                   ? createRSO(input, inputElf, output, options.fullpath, options.exportList,
+                               options.importedSymbols, options.symbolMap,
+                               options.compactRelocations, options.groupRelocations, options.jobs,
+                               convertor, log, stats)
+                   : createStaticRSO(input, inputElf, output, options.fullpath,
+                                     options.exportList, options.importedSymbols, convertor, log,
+                                     stats);
+    };
 
-    return 0;
+    // The inputs are big-endian PowerPC objects, their tables are read with the byte order fixed
+    // at compile time. Other inputs go through the run-time convertor
+    const auto result = inputElf.get_encoding() == ELFDATA2MSB
+                            ? convert(ELFIO::fixed_endianess_convertor<ELFDATA2MSB>())
+                            : convert(inputElf.get_convertor());
+
+    if (result == 0 && options.cache && cacheKey != 0)
+    {
+        stats.phase("Cache update");
+        options.cache->store(modulePath, cacheKey);
+    }
+
+    stats.endPhase();
+    return result;
 }
 
-int createStaticRSO(fs::path input, ELFIO::elfio inputElf, fs::path output, bool fullpath,
-                    std::unique_ptr<std::vector<std::string>> exportList)
+// Convert a module and append its statistics to the log, when requested
+int convertModule(const fs::path& input, const fs::path& output, const ConversionOptions& options,
+                  ConversionLog& log)
 {
-    output.replace_extension(".sel");
-    printf("Error! Creating a static rso module is not supported yet!");
-    return 1;
+    ConversionStats stats;
+    const auto result = convertModule(input, output, options, log, stats);
+
+    if (options.statsFormat == ConversionOptions::StatsFormat::Text)
+    {
+        log.print("%s", stats.toText(input.string()).c_str());
+    }
+    else if (options.statsFormat == ConversionOptions::StatsFormat::Json)
+    {
+        log.print("%s", stats.toJson(input.string()).c_str());
+    }
+
+    return result;
+}
+
+// Read the ELF type from the header without loading the file. Returns ET_NONE if it isn't an ELF
+ELFIO::Elf_Half peekElfType(const fs::path& input)
+{
+    std::array<unsigned char, 18> ident{};
+    std::ifstream inputFile(input, std::ios::binary);
+    if (!inputFile.read(reinterpret_cast<char*>(ident.data()), ident.size()) ||
+        ident[EI_MAG0] != ELFMAG0 || ident[EI_MAG1] != ELFMAG1 || ident[EI_MAG2] != ELFMAG2 ||
+        ident[EI_MAG3] != ELFMAG3)
+    {
+        return ET_NONE;
+    }
+
+    if (ident[EI_DATA] == ELFDATA2MSB)
+    {
+        return static_cast<ELFIO::Elf_Half>((ident[16] << 8) | ident[17]);
+    }
+
+    return static_cast<ELFIO::Elf_Half>((ident[17] << 8) | ident[16]);
 }
 
 int main(int argc, char** argv)
 {
-    optparse::OptionParser parser = optparse::OptionParser().description("Elf2RSO v1.0");
+    optparse::OptionParser parser =
+        optparse::OptionParser().description("Elf2RSO v1.0").usage("%prog [options] [FILE...]");
 
     parser.add_option("-i", "--input").dest("input").help("ELF File").metavar("FILE");
-    parser.add_option("-o", "--output").dest("output").set_default("").help("Output file");
+    parser.add_option("-o", "--output")
+        .dest("output")
+        .set_default("")
+        .help("Output file. Output directory when converting multiple files");
     parser.add_option("-a", "--fullpath")
         .dest("fullpath")
         .action("true")
@@ -580,61 +1326,242 @@ int main(int argc, char** argv)
         .help("Use fullpath for module name");
     parser.add_option("-e", "--export")
         .dest("export")
-        .help("File with a list of exported symbol. Divided by `\n`");
+        .help("File with a list of exported symbol. Divided by `\n`. Supports `*` and `?` wildcards");
     parser.add_option("-ne", "--no-export")
         .dest("no-export")
         .help("Don't export any symbol from the module");
+    parser.add_option("-b", "--batch")
+        .dest("batch")
+        .help("File with a list of ELF files to convert. One per line")
+        .metavar("FILE");
+    parser.add_option("-j", "--jobs")
+        .dest("jobs")
+        .type("int")
+        .set_default(0)
+        .help("Number of threads used for the conversion. Default is one per CPU core");
+    parser.add_option("-c", "--cache")
+        .dest("cache")
+        .action("store_true")
+        .help("Skip modules whose input and options didn't change since the last conversion");
+    parser.add_option("-l", "--link")
+        .dest("link")
+        .help("Static module (.sel) or executable ELF used to resolve the imports with a fixed "
+              "address at build time")
+        .metavar("FILE");
+    parser.add_option("-r", "--compact-relocations")
+        .dest("compact-relocations")
+        .action("store_true")
+        .help("Resolve the branches within a section at conversion time and drop duplicated "
+              "relocations");
+    parser.add_option("-g", "--group-relocations")
+        .dest("group-relocations")
+        .action("store_true")
+        .help("Order the internal relocations by target section and offset, and the external "
+              "ones by symbol and offset");
+    parser.add_option("-p", "--prune-exports")
+        .dest("prune-exports")
+        .action("store_true")
+        .help("Only export from the static module the symbols imported by the other modules");
+    parser.add_option("--stats")
+        .dest("stats")
+        .action("store_true")
+        .help("Print the time spent in every conversion phase and some counters of each module");
+    parser.add_option("--stats-json")
+        .dest("stats-json")
+        .action("store_true")
+        .help("Same as `--stats` but printed as one JSON object per module");
+    parser.add_option("--cache-stats")
+        .dest("cache-stats")
+        .action("store_true")
+        .help("Print the conversion cache hit/miss counters");
 
     const optparse::Values options = parser.parse_args(argc, argv);
 
-    if (!options.is_set("input"))
+    std::vector<fs::path> inputs;
+    if (options.is_set("input"))
     {
-        parser.print_help();
-        return -1;
+        inputs.emplace_back(options["input"]);
     }
 
-    const auto elfFile = options["input"];
-    fs::path outputFile;
-    if (!options.is_set_by_user("output"))
+    for (const auto& arg : parser.args())
     {
-        outputFile = elfFile;
+        inputs.emplace_back(arg);
     }
-    else
+
+    if (options.is_set_by_user("batch"))
+    {
+        const auto batch = readBatchFile(options.get("batch"));
+        inputs.insert(inputs.end(), batch.begin(), batch.end());
+    }
+
+    if (inputs.empty())
+    {
+        parser.print_help();
+        return -1;
+    }
+
+    // The static module only exports the imports of the modules converted with it, without them
+    // it would export nothing
+    if (options.get("prune-exports") &&
+        std::none_of(inputs.begin(), inputs.end(),
+                     [](const fs::path& input) { return peekElfType(input) == ET_REL; }))
     {
-        outputFile = options.get("output");
+        printf("Error! -p requires at least one module (ET_REL) converted in the same run\n");
+        return 1;
     }
 
-    std::unique_ptr<std::vector<std::string>> exportList;
+    std::unique_ptr<ExportList> exportList;
     if (options.is_set_by_user("no-export"))
     {
-        exportList = std::make_unique<std::vector<std::string>>();
+        exportList = std::make_unique<ExportList>();
     }
 
     if (options.is_set_by_user("export"))
     {
-        exportList = std::make_unique<std::vector<std::string>>(
-            std::move(readExportFile(options.get("export"))));
+        exportList = std::make_unique<ExportList>(readExportFile(options.get("export")));
     }
 
-    // Load input file
-    ELFIO::elfio inputElf;
-    if (!inputElf.load(elfFile))
+    std::unique_ptr<SymbolMap> symbolMap;
+    if (options.is_set_by_user("link"))
     {
-        printf("Failed to load input file\n");
-        return 1;
+        symbolMap = std::make_unique<SymbolMap>();
+        if (!symbolMap->load(options.get("link")))
+        {
+            printf("Error! Unable to read the symbols of: %s\n", options["link"].c_str());
+            return 1;
+        }
     }
 
-    const bool useFullPath = options.get("fullpath");
+    ConversionCache cache;
+    SymbolInternTable importedSymbols;
+
+    ConversionOptions conversionOptions;
+    conversionOptions.fullpath = options.get("fullpath");
+    conversionOptions.exportList = exportList.get();
+    conversionOptions.cache = options.get("cache") ? &cache : nullptr;
+    conversionOptions.importedSymbols = options.get("prune-exports") ? &importedSymbols : nullptr;
+    conversionOptions.symbolMap = symbolMap.get();
+    conversionOptions.compactRelocations = options.get("compact-relocations");
+    conversionOptions.groupRelocations = options.get("group-relocations");
 
-    if (inputElf.get_type() == ET_REL)
+    if (options.get("stats-json"))
     {
-        return createRSO(elfFile, inputElf, outputFile, useFullPath, std::move(exportList));
+        conversionOptions.statsFormat = ConversionOptions::StatsFormat::Json;
     }
-    else if (inputElf.get_type() != ET_EXEC)
+    else if (options.get("stats"))
     {
-        printf("Error! Unsupported binary ELF type: %d", inputElf.get_type());
-        return 1;
+        conversionOptions.statsFormat = ConversionOptions::StatsFormat::Text;
     }
 
-    return createStaticRSO(elfFile, inputElf, outputFile, useFullPath, std::move(exportList));
+    const int jobs = options.get("jobs");
+    conversionOptions.jobs = jobs > 0 ? static_cast<unsigned>(jobs) : defaultJobCount();
+
+    conversionOptions.hash = Hash::combine(0, cOutputVersion);
+    conversionOptions.hash = Hash::combine(conversionOptions.hash, conversionOptions.fullpath);
+    conversionOptions.hash =
+        Hash::combine(conversionOptions.hash, conversionOptions.compactRelocations);
+    conversionOptions.hash =
+        Hash::combine(conversionOptions.hash, conversionOptions.groupRelocations);
+    conversionOptions.hash = Hash::combine(
+        conversionOptions.hash, exportList ? exportList->fingerprint() : ~static_cast<u64>(0));
+    conversionOptions.hash = Hash::combine(
+        conversionOptions.hash, symbolMap ? symbolMap->fingerprint() : ~static_cast<u64>(0));
+
+    const auto printCacheStats = [&]() {
+        if (options.get("cache-stats"))
+        {
+            printf("Cache: %zu hits, %zu misses\n", cache.hits(), cache.misses());
+        }
+    };
+
+    if (inputs.size() == 1)
+    {
+        fs::path outputFile;
+        if (!options.is_set_by_user("output"))
+        {
+            outputFile = inputs.front();
+        }
+        else
+        {
+            outputFile = options.get("output");
+        }
+
+        ConversionLog log;
+        const auto result = convertModule(inputs.front(), outputFile, conversionOptions, log);
+        fputs(log.str().c_str(), stdout);
+        printCacheStats();
+        return result;
+    }
+
+    // Batch conversion. Every module is written next to its input unless an output directory
+    // was given. Modules already run in parallel, so each of them is converted by a single thread
+    auto moduleOptions = conversionOptions;
+    moduleOptions.jobs = 1;
+
+    std::vector<fs::path> outputs(inputs.size());
+    for (size_t idx = 0; idx < inputs.size(); ++idx)
+    {
+        outputs[idx] = inputs[idx];
+        if (options.is_set_by_user("output"))
+        {
+            outputs[idx] = fs::path(options["output"]) / inputs[idx].filename();
+        }
+    }
+
+    // Modules are written concurrently, two inputs must not write the same file (e.g. inputs with
+    // the same name from different directories and an output directory)
+    std::map<fs::path, size_t> modulePaths;
+    for (size_t idx = 0; idx < inputs.size(); ++idx)
+    {
+        auto modulePath = fs::absolute(outputs[idx]).lexically_normal();
+        modulePath.replace_extension(peekElfType(inputs[idx]) == ET_EXEC ? ".sel" : ".rso");
+
+        const auto [it, inserted] = modulePaths.emplace(modulePath, idx);
+        if (!inserted)
+        {
+            printf("Error! %s and %s are both written to %s\n",
+                   inputs[it->second].string().c_str(), inputs[idx].string().c_str(),
+                   modulePath.string().c_str());
+            return 1;
+        }
+    }
+
+    // When pruning the exports, the static modules need the imports of every other module, so they
+    // are converted last
+    std::vector<size_t> order(inputs.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    auto staticBegin = order.end();
+    if (conversionOptions.importedSymbols)
+    {
+        staticBegin = std::stable_partition(order.begin(), order.end(), [&](size_t idx) {
+            return peekElfType(inputs[idx]) != ET_EXEC;
+        });
+    }
+
+    std::vector<int> results(inputs.size(), 0);
+    std::mutex outputMutex;
+    const auto convertInput = [&](size_t idx) {
+        const auto& input = inputs[idx];
+        ConversionLog log;
+        results[idx] = convertModule(input, outputs[idx], moduleOptions, log);
+
+        std::lock_guard<std::mutex> lock(outputMutex);
+        printf("[%s] %s\n", results[idx] == 0 ? "OK" : "FAILED", input.string().c_str());
+        fputs(log.str().c_str(), stdout);
+    };
+
+    const auto dynamicCount = static_cast<size_t>(staticBegin - order.begin());
+    parallelFor(dynamicCount, conversionOptions.jobs,
+                [&](size_t idx) { convertInput(order[idx]); });
+    parallelFor(order.size() - dynamicCount, conversionOptions.jobs,
+                [&](size_t idx) { convertInput(order[dynamicCount + idx]); });
+
+    const auto failed = std::count_if(results.begin(), results.end(),
+                                      [](int result) { return result != 0; });
+    printf("Converted %zu of %zu modules\n", inputs.size() - static_cast<size_t>(failed),
+           inputs.size());
+    printCacheStats();
+
+    return failed == 0 ? 0 : 1;
 }
@@ -45,6 +45,7 @@ THE SOFTWARE.
 #include <elfio/elfio_section.hpp>
 #include <elfio/elfio_segment.hpp>
 #include <elfio/elfio_strings.hpp>
+#include <elfio/elfio_mapped_file.hpp>
 
 #define ELFIO_HEADER_ACCESS_GET( TYPE, FNAME ) \
 TYPE                                           \
@@ -95,15 +96,18 @@ class elfio
     }
 
 //------------------------------------------------------------------------------
+    // Section data is read on first access through a file handle kept open
+    // until the next load or the destruction of this object.
     bool load( const std::string& file_name )
     {
-        std::ifstream stream;
-        stream.open( file_name.c_str(), std::ios::in | std::ios::binary );
-        if ( !stream ) {
+        clean();
+
+        file_stream.open( file_name.c_str(), std::ios::in | std::ios::binary );
+        if ( !file_stream ) {
             return false;
         }
 
-        return load(stream);
+        return load_image( file_stream, 0, 0, true );
     }
 
 //------------------------------------------------------------------------------
@@ -111,40 +115,23 @@ class elfio
     {
         clean();
 
-        unsigned char e_ident[EI_NIDENT];
-
-        // Read ELF file signature
-        stream.seekg( 0 );
-        stream.read( reinterpret_cast<char*>( &e_ident ), sizeof( e_ident ) );
-
-        // Is it ELF file?
-        if ( stream.gcount() != sizeof( e_ident ) ||
-             e_ident[EI_MAG0] != ELFMAG0    ||
-             e_ident[EI_MAG1] != ELFMAG1    ||
-             e_ident[EI_MAG2] != ELFMAG2    ||
-             e_ident[EI_MAG3] != ELFMAG3 ) {
-            return false;
-        }
-
-        if ( ( e_ident[EI_CLASS] != ELFCLASS64 ) &&
-             ( e_ident[EI_CLASS] != ELFCLASS32 )) {
-            return false;
-        }
+        return load_image( stream, 0, 0, false );
+    }
 
-        convertor.setup( e_ident[EI_DATA] );
+//------------------------------------------------------------------------------
+    // Map the file instead of reading it. Section and segment data point
+    // straight into the mapping, which stays alive until the next load or
+    // the destruction of this object.
+    bool load_mapped( const std::string& file_name )
+    {
+        clean();
 
-        header = create_header( e_ident[EI_CLASS], e_ident[EI_DATA] );
-        if ( 0 == header ) {
+        if ( !mapping.open( file_name ) ) {
             return false;
         }
-        if ( !header->load( stream ) ) {
-            return false;
-        }
-
-        load_sections( stream );
-        load_segments( stream );
 
-        return true;
+        memory_istream stream( mapping.data(), mapping.size() );
+        return load_image( stream, mapping.data(), mapping.size(), false );
     }
 
 //------------------------------------------------------------------------------
@@ -266,6 +253,52 @@ class elfio
             delete *it1;
         }
         segments_.clear();
+
+        mapping.close();
+        if ( file_stream.is_open() ) {
+            file_stream.close();
+        }
+        file_stream.clear();
+    }
+
+//------------------------------------------------------------------------------
+    bool load_image( std::istream& stream, const char* image, Elf_Xword image_size,
+                     bool lazy )
+    {
+        unsigned char e_ident[EI_NIDENT];
+
+        // Read ELF file signature
+        stream.seekg( 0 );
+        stream.read( reinterpret_cast<char*>( &e_ident ), sizeof( e_ident ) );
+
+        // Is it ELF file?
+        if ( stream.gcount() != sizeof( e_ident ) ||
+             e_ident[EI_MAG0] != ELFMAG0    ||
+             e_ident[EI_MAG1] != ELFMAG1    ||
+             e_ident[EI_MAG2] != ELFMAG2    ||
+             e_ident[EI_MAG3] != ELFMAG3 ) {
+            return false;
+        }
+
+        if ( ( e_ident[EI_CLASS] != ELFCLASS64 ) &&
+             ( e_ident[EI_CLASS] != ELFCLASS32 )) {
+            return false;
+        }
+
+        convertor.setup( e_ident[EI_DATA] );
+
+        header = create_header( e_ident[EI_CLASS], e_ident[EI_DATA] );
+        if ( 0 == header ) {
+            return false;
+        }
+        if ( !header->load( stream ) ) {
+            return false;
+        }
+
+        load_sections( stream, image, image_size, lazy );
+        load_segments( stream, image, image_size );
+
+        return true;
     }
 
 //------------------------------------------------------------------------------
@@ -350,7 +383,8 @@ class elfio
     }
 
 //------------------------------------------------------------------------------
-    Elf_Half load_sections( std::istream& stream )
+    Elf_Half load_sections( std::istream& stream, const char* image, Elf_Xword image_size,
+                            bool lazy )
     {
         Elf_Half  entry_size = header->get_section_entry_size();
         Elf_Half  num        = header->get_sections_num();
@@ -358,7 +392,16 @@ class elfio
 
         for ( Elf_Half i = 0; i < num; ++i ) {
             section* sec = create_section();
-            sec->load( stream, (std::streamoff)offset + i * entry_size );
+            if ( 0 != image ) {
+                sec->load_mapped( stream, (std::streamoff)offset + i * entry_size,
+                                  image, image_size );
+            }
+            else if ( lazy ) {
+                sec->load_lazy( stream, (std::streamoff)offset + i * entry_size );
+            }
+            else {
+                sec->load( stream, (std::streamoff)offset + i * entry_size );
+            }
             sec->set_index( i );
             // To mark that the section is not permitted to reassign address
             // during layout calculation
@@ -382,7 +425,7 @@ class elfio
     }
 
 //------------------------------------------------------------------------------
-    bool load_segments( std::istream& stream )
+    bool load_segments( std::istream& stream, const char* image, Elf_Xword image_size )
     {
         Elf_Half  entry_size = header->get_segment_entry_size();
         Elf_Half  num        = header->get_segments_num();
@@ -402,7 +445,13 @@ class elfio
                 return false;
             }
 
-            seg->load( stream, (std::streamoff)offset + i * entry_size );
+            if ( 0 != image ) {
+                seg->load_mapped( stream, (std::streamoff)offset + i * entry_size,
+                                  image, image_size );
+            }
+            else {
+                seg->load( stream, (std::streamoff)offset + i * entry_size );
+            }
             seg->set_index( i );
 
             // Add sections to the segments (similar to readelfs algorithm)
@@ -830,6 +879,8 @@ class elfio
     std::vector<section*> sections_;
     std::vector<segment*> segments_;
     endianess_convertor   convertor;
+    mapped_file           mapping;
+    std::ifstream         file_stream;
 
     Elf_Xword current_file_pos;
 };
@@ -0,0 +1,207 @@
+/*
+Copyright (C) 2001-2015 by Serge Lamikhov-Center
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#ifndef ELFIO_MAPPED_FILE_HPP
+#define ELFIO_MAPPED_FILE_HPP
+
+#include <string>
+#include <istream>
+#include <streambuf>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ELFIO {
+
+//------------------------------------------------------------------------------
+// Read-only view of a whole file mapped into memory
+class mapped_file
+{
+  public:
+//------------------------------------------------------------------------------
+    mapped_file() : image( 0 ), image_size( 0 )
+    {
+    }
+
+//------------------------------------------------------------------------------
+    ~mapped_file()
+    {
+        close();
+    }
+
+//------------------------------------------------------------------------------
+    bool
+    open( const std::string& file_name )
+    {
+        close();
+
+#ifdef _WIN32
+        HANDLE file = CreateFileA( file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, 0,
+                                   OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0 );
+        if ( file == INVALID_HANDLE_VALUE ) {
+            return false;
+        }
+
+        LARGE_INTEGER file_size;
+        if ( !GetFileSizeEx( file, &file_size ) || file_size.QuadPart == 0 ) {
+            CloseHandle( file );
+            return false;
+        }
+
+        HANDLE mapping = CreateFileMappingA( file, 0, PAGE_READONLY, 0, 0, 0 );
+        CloseHandle( file );
+        if ( mapping == 0 ) {
+            return false;
+        }
+
+        image = static_cast<const char*>( MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 ) );
+        CloseHandle( mapping );
+        if ( image == 0 ) {
+            return false;
+        }
+
+        image_size = static_cast<Elf_Xword>( file_size.QuadPart );
+#else
+        int fd = ::open( file_name.c_str(), O_RDONLY );
+        if ( fd < 0 ) {
+            return false;
+        }
+
+        struct stat st;
+        if ( fstat( fd, &st ) != 0 || st.st_size == 0 ) {
+            ::close( fd );
+            return false;
+        }
+
+        void* addr = mmap( 0, static_cast<size_t>( st.st_size ), PROT_READ, MAP_PRIVATE, fd, 0 );
+        ::close( fd );
+        if ( addr == MAP_FAILED ) {
+            return false;
+        }
+
+        image      = static_cast<const char*>( addr );
+        image_size = static_cast<Elf_Xword>( st.st_size );
+#endif
+
+        return true;
+    }
+
+//------------------------------------------------------------------------------
+    void
+    close()
+    {
+        if ( 0 != image ) {
+#ifdef _WIN32
+            UnmapViewOfFile( image );
+#else
+            munmap( const_cast<char*>( image ), static_cast<size_t>( image_size ) );
+#endif
+        }
+
+        image      = 0;
+        image_size = 0;
+    }
+
+//------------------------------------------------------------------------------
+    const char*
+    data() const
+    {
+        return image;
+    }
+
+//------------------------------------------------------------------------------
+    Elf_Xword
+    size() const
+    {
+        return image_size;
+    }
+
+//------------------------------------------------------------------------------
+  private:
+    mapped_file( const mapped_file& );
+    mapped_file& operator=( const mapped_file& );
+
+    const char* image;
+    Elf_Xword   image_size;
+};
+
+
+//------------------------------------------------------------------------------
+// std::istream over a memory range, used to parse headers out of a mapped image
+class memory_istream : private std::streambuf, public std::istream
+{
+  public:
+//------------------------------------------------------------------------------
+    memory_istream( const char* begin, Elf_Xword size ) :
+        std::istream( static_cast<std::streambuf*>( this ) )
+    {
+        char* p = const_cast<char*>( begin );
+        setg( p, p, p + size );
+    }
+
+//------------------------------------------------------------------------------
+  protected:
+    typedef std::streambuf::pos_type pos_type;
+    typedef std::streambuf::off_type off_type;
+
+    pos_type
+    seekoff( off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which )
+    {
+        char* target;
+        if ( dir == std::ios_base::beg ) {
+            target = eback() + off;
+        }
+        else if ( dir == std::ios_base::cur ) {
+            target = gptr() + off;
+        }
+        else {
+            target = egptr() + off;
+        }
+
+        if ( !( which & std::ios_base::in ) || target < eback() || target > egptr() ) {
+            return pos_type( off_type( -1 ) );
+        }
+
+        setg( eback(), target, egptr() );
+        return pos_type( target - eback() );
+    }
+
+//------------------------------------------------------------------------------
+    pos_type
+    seekpos( pos_type pos, std::ios_base::openmode which )
+    {
+        return seekoff( off_type( pos ), std::ios_base::beg, which );
+    }
+};
+
+} // namespace ELFIO
+
+#endif // ELFIO_MAPPED_FILE_HPP
@@ -71,6 +71,85 @@ template<> struct get_sym_and_type< Elf64_Rela >
     }
 };
 
+template<typename T> struct get_addend
+{
+    template< class C >
+    static Elf_Sxword get_r_addend( const T& entry, const C& convertor )
+    {
+        return convertor( entry.r_addend );
+    }
+};
+template<> struct get_addend< Elf32_Rel >
+{
+    template< class C >
+    static Elf_Sxword get_r_addend( const Elf32_Rel&, const C& )
+    {
+        return 0;
+    }
+};
+template<> struct get_addend< Elf64_Rel >
+{
+    template< class C >
+    static Elf_Sxword get_r_addend( const Elf64_Rel&, const C& )
+    {
+        return 0;
+    }
+};
+
+
+//------------------------------------------------------------------------------
+struct relocation_entry
+{
+    Elf64_Addr offset;
+    Elf_Word   symbol;
+    Elf_Word   type;
+    Elf_Sxword addend;
+};
+
+//------------------------------------------------------------------------------
+// Read-only view over the entries of a relocation section of type `T`
+// (Elf32_Rel, Elf32_Rela, Elf64_Rel or Elf64_Rela). Entries are decoded on
+// access with `C`, nothing is allocated
+template< class T, class C = endianess_convertor >
+class relocation_table_view
+{
+  public:
+//------------------------------------------------------------------------------
+    relocation_table_view( const char* entries_, Elf_Xword entry_size_, Elf_Xword count_,
+                           const C&    convertor_ ) :
+        entries( entries_ ), entry_size( entry_size_ ), count( count_ ),
+        convertor( convertor_ )
+    {
+    }
+
+//------------------------------------------------------------------------------
+    Elf_Xword size() const { return count; }
+
+//------------------------------------------------------------------------------
+    // `index` must be lower than `size()`
+    relocation_entry
+    operator[]( Elf_Xword index ) const
+    {
+        const T* pEntry = reinterpret_cast<const T*>( entries + index * entry_size );
+
+        relocation_entry entry;
+        entry.offset  = convertor( pEntry->r_offset );
+        Elf_Xword tmp = convertor( pEntry->r_info );
+        entry.symbol  = get_sym_and_type<T>::get_r_sym( tmp );
+        entry.type    = get_sym_and_type<T>::get_r_type( tmp );
+        entry.addend  = get_addend<T>::get_r_addend( *pEntry, convertor );
+
+        return entry;
+    }
+
+//------------------------------------------------------------------------------
+  private:
+    const char* entries;
+    Elf_Xword   entry_size;
+    Elf_Xword   count;
+    C           convertor;
+};
+
 
 //------------------------------------------------------------------------------
 class relocation_section_accessor
@@ -132,6 +211,28 @@ class relocation_section_accessor
         return true;
     }
 
+//------------------------------------------------------------------------------
+    // Allocation free access to every entry. `T` must match the ELF class and
+    // the section type
+    template< class T >
+    relocation_table_view<T>
+    get_view() const
+    {
+        return get_view<T>( elf_file.get_convertor() );
+    }
+
+//------------------------------------------------------------------------------
+    // Same with a convertor fixed at compile time (fixed_endianess_convertor),
+    // which must match the ELF encoding
+    template< class T, class C >
+    relocation_table_view<T, C>
+    get_view( const C& convertor ) const
+    {
+        return relocation_table_view<T, C>( relocation_section->get_data(),
+                                            relocation_section->get_entry_size(),
+                                            get_entries_num(), convertor );
+    }
+
 //------------------------------------------------------------------------------
     bool
     get_entry( Elf_Xword    index,
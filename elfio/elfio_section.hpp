@@ -45,6 +45,7 @@ class section
     ELFIO_GET_SET_ACCESS_DECL( Elf64_Addr,  address            );
     ELFIO_GET_SET_ACCESS_DECL( Elf_Xword,   size               );
     ELFIO_GET_SET_ACCESS_DECL( Elf_Word,    name_string_offset );
+    ELFIO_GET_ACCESS_DECL    ( Elf64_Off,   offset             );
 
     virtual const char* get_data() const                                = 0;
     virtual void        set_data( const char* pData, Elf_Word size )    = 0;
@@ -53,11 +54,17 @@ class section
     virtual void        append_data( const std::string& data )          = 0;
 
   protected:
-    ELFIO_GET_SET_ACCESS_DECL( Elf64_Off, offset );
+    ELFIO_SET_ACCESS_DECL( Elf64_Off, offset );
     ELFIO_SET_ACCESS_DECL( Elf_Half,  index  );
     
     virtual void load( std::istream&  f,
                        std::streampos header_offset ) = 0;
+    virtual void load_lazy( std::istream&  f,
+                            std::streampos header_offset ) = 0;
+    virtual void load_mapped( std::istream&  f,
+                              std::streampos header_offset,
+                              const char*    image,
+                              Elf_Xword      image_size ) = 0;
     virtual void save( std::ostream&  f,
                        std::streampos header_offset,
                        std::streampos data_offset )   = 0;
@@ -74,14 +81,16 @@ class section_impl : public section
     {
         std::fill_n( reinterpret_cast<char*>( &header ), sizeof( header ), '\0' );
         is_address_set = false;
+        is_data_mapped = false;
         data           = 0;
         data_size      = 0;
+        data_stream    = 0;
     }
 
 //------------------------------------------------------------------------------
     ~section_impl()
     {
-        delete [] data;
+        release_data();
     }
 
 //------------------------------------------------------------------------------
@@ -138,6 +147,10 @@ class section_impl : public section
     const char*
     get_data() const
     {
+        if ( 0 != data_stream ) {
+            load_data();
+        }
+
         return data;
     }
 
@@ -145,8 +158,9 @@ class section_impl : public section
     void
     set_data( const char* raw_data, Elf_Word size )
     {
+        data_stream = 0;
         if ( get_type() != SHT_NOBITS ) {
-            delete [] data;
+            release_data();
             try {
                 data = new char[size];
             } catch (const std::bad_alloc&) {
@@ -174,6 +188,7 @@ class section_impl : public section
     void
     append_data( const char* raw_data, Elf_Word size )
     {
+        get_data();
         if ( get_type() != SHT_NOBITS ) {
             if ( get_size() + size < data_size ) {
                 std::copy( raw_data, raw_data + size, data + get_size() );
@@ -190,7 +205,7 @@ class section_impl : public section
                 if ( 0 != new_data ) {
                     std::copy( data, data + get_size(), new_data );
                     std::copy( raw_data, raw_data + size, new_data + get_size() );
-                    delete [] data;
+                    release_data();
                     data = new_data;
                 }
             }
@@ -242,6 +257,44 @@ class section_impl : public section
         }
     }
 
+//------------------------------------------------------------------------------
+    // Only read the header now; the payload is read from `stream` on the
+    // first get_data() call, so `stream` must outlive this section.
+    void
+    load_lazy( std::istream&  stream,
+               std::streampos header_offset )
+    {
+        std::fill_n( reinterpret_cast<char*>( &header ), sizeof( header ), '\0' );
+        stream.seekg( header_offset );
+        stream.read( reinterpret_cast<char*>( &header ), sizeof( header ) );
+
+        if ( 0 == data && SHT_NULL != get_type() && SHT_NOBITS != get_type() ) {
+            data_stream = &stream;
+        }
+    }
+
+//------------------------------------------------------------------------------
+    void
+    load_mapped( std::istream&  stream,
+                 std::streampos header_offset,
+                 const char*    image,
+                 Elf_Xword      image_size )
+    {
+        std::fill_n( reinterpret_cast<char*>( &header ), sizeof( header ), '\0' );
+        stream.seekg( header_offset );
+        stream.read( reinterpret_cast<char*>( &header ), sizeof( header ) );
+
+        // Point straight into the mapping; the data is never copied nor owned
+        Elf_Xword size   = get_size();
+        Elf64_Off offset = (*convertor)( header.sh_offset );
+        if ( 0 == data && SHT_NULL != get_type() && SHT_NOBITS != get_type() &&
+             offset <= image_size && size <= image_size - offset ) {
+            data           = const_cast<char*>( image + offset );
+            data_size      = 0;
+            is_data_mapped = true;
+        }
+    }
+
 //------------------------------------------------------------------------------
     void
     save( std::ostream&  f,
@@ -255,13 +308,46 @@ class section_impl : public section
 
         save_header( f, header_offset );
         if ( get_type() != SHT_NOBITS && get_type() != SHT_NULL &&
-             get_size() != 0 && data != 0 ) {
+             get_size() != 0 && get_data() != 0 ) {
             save_data( f, data_offset );
         }
     }
 
 //------------------------------------------------------------------------------
   private:
+//------------------------------------------------------------------------------
+    void
+    load_data() const
+    {
+        std::istream& stream = *data_stream;
+        data_stream          = 0;
+
+        Elf_Xword size = get_size();
+        try {
+            data = new char[size];
+        } catch (const std::bad_alloc&) {
+            data      = 0;
+            data_size = 0;
+        }
+        if ( 0 != data && 0 != size ) {
+            stream.clear();
+            stream.seekg( (*convertor)( header.sh_offset ) );
+            stream.read( data, size );
+            data_size = size;
+        }
+    }
+
+//------------------------------------------------------------------------------
+    void
+    release_data()
+    {
+        if ( !is_data_mapped ) {
+            delete [] data;
+        }
+        data           = 0;
+        is_data_mapped = false;
+    }
+
 //------------------------------------------------------------------------------
     void
     save_header( std::ostream&  f,
@@ -285,10 +371,12 @@ class section_impl : public section
     T                          header;
     Elf_Half                   index;
     std::string                name;
-    char*                      data;
-    Elf_Word                   data_size;
+    mutable char*              data;
+    mutable Elf_Word           data_size;
+    mutable std::istream*      data_stream;
     const endianess_convertor* convertor;
     bool                       is_address_set;
+    bool                       is_data_mapped;
 };
 
 } // namespace ELFIO
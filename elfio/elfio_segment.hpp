@@ -57,6 +57,8 @@ class segment
     
     virtual const std::vector<Elf_Half>& get_sections() const               = 0;
     virtual void load( std::istream& stream, std::streampos header_offset ) = 0;
+    virtual void load_mapped( std::istream& stream, std::streampos header_offset,
+                              const char* image, Elf_Xword image_size )     = 0;
     virtual void save( std::ostream& f,      std::streampos header_offset,
                                              std::streampos data_offset )   = 0;
 };
@@ -73,13 +75,16 @@ class segment_impl : public segment
     {
         is_offset_set = false;
         std::fill_n( reinterpret_cast<char*>( &ph ), sizeof( ph ), '\0' );
-        data = 0;
+        data           = 0;
+        is_data_mapped = false;
     }
 
 //------------------------------------------------------------------------------
     virtual ~segment_impl()
     {
-        delete [] data;
+        if ( !is_data_mapped ) {
+            delete [] data;
+        }
     }
 
 //------------------------------------------------------------------------------
@@ -194,6 +199,26 @@ class segment_impl : public segment
         }
     }
 
+//------------------------------------------------------------------------------
+    void
+    load_mapped( std::istream&  stream,
+                 std::streampos header_offset,
+                 const char*    image,
+                 Elf_Xword      image_size )
+    {
+        stream.seekg( header_offset );
+        stream.read( reinterpret_cast<char*>( &ph ), sizeof( ph ) );
+        is_offset_set = true;
+
+        Elf_Xword size   = get_file_size();
+        Elf64_Off offset = (*convertor)( ph.p_offset );
+        if ( PT_NULL != get_type() && 0 != size &&
+             offset <= image_size && size <= image_size - offset ) {
+            data           = const_cast<char*>( image + offset );
+            is_data_mapped = true;
+        }
+    }
+
 //------------------------------------------------------------------------------
     void save( std::ostream&  f,
                std::streampos header_offset,
@@ -213,6 +238,7 @@ class segment_impl : public segment
     std::vector<Elf_Half> sections;
     endianess_convertor*  convertor;
     bool                  is_offset_set;
+    bool                  is_data_mapped;
 };
 
 } // namespace ELFIO
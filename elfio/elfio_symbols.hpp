@@ -23,8 +23,119 @@ THE SOFTWARE.
 #ifndef ELFIO_SYMBOLS_HPP
 #define ELFIO_SYMBOLS_HPP
 
+#include <cstring>
+#include <iterator>
+#include <string_view>
+
 namespace ELFIO {
 
+//------------------------------------------------------------------------------
+// Decoded symbol table entry. `name` points into the string table section,
+// so it's valid while the section data is loaded
+struct symbol_entry
+{
+    std::string_view name;
+    Elf64_Addr       value;
+    Elf_Xword        size;
+    unsigned char    bind;
+    unsigned char    type;
+    Elf_Half         section_index;
+    unsigned char    other;
+};
+
+//------------------------------------------------------------------------------
+// Read-only view over the entries of a symbol table of class `T` (Elf32_Sym or
+// Elf64_Sym). Entries are decoded on access with `C`, nothing is allocated
+template< class T, class C = endianess_convertor >
+class symbol_table_view
+{
+  public:
+//------------------------------------------------------------------------------
+    class iterator
+    {
+      public:
+        typedef std::forward_iterator_tag       iterator_category;
+        typedef symbol_entry                    value_type;
+        typedef std::ptrdiff_t                  difference_type;
+        typedef const symbol_entry*             pointer;
+        typedef symbol_entry                    reference;
+
+        iterator( const symbol_table_view* view_, Elf_Xword index_ ) :
+            view( view_ ), index( index_ )
+        {
+        }
+
+        symbol_entry operator*() const { return ( *view )[index]; }
+        iterator&    operator++()      { ++index; return *this; }
+        iterator     operator++( int ) { iterator it = *this; ++index; return it; }
+
+        Elf_Xword get_index() const { return index; }
+
+        bool operator==( const iterator& other ) const { return index == other.index; }
+        bool operator!=( const iterator& other ) const { return index != other.index; }
+
+      private:
+        const symbol_table_view* view;
+        Elf_Xword                index;
+    };
+
+//------------------------------------------------------------------------------
+    symbol_table_view( const char* entries_, Elf_Xword entry_size_, Elf_Xword count_,
+                       const char* strings_, Elf_Xword strings_size_,
+                       const C&    convertor_ ) :
+        entries( entries_ ), entry_size( entry_size_ ), count( count_ ),
+        strings( strings_ ), strings_size( strings_size_ ), convertor( convertor_ )
+    {
+    }
+
+//------------------------------------------------------------------------------
+    Elf_Xword size() const { return count; }
+    iterator  begin() const { return iterator( this, 0 ); }
+    iterator  end() const { return iterator( this, count ); }
+
+//------------------------------------------------------------------------------
+    // `index` must be lower than `size()`
+    symbol_entry
+    operator[]( Elf_Xword index ) const
+    {
+        const T* pSym = reinterpret_cast<const T*>( entries + index * entry_size );
+
+        symbol_entry entry;
+        entry.name          = get_name( convertor( pSym->st_name ) );
+        entry.value         = convertor( pSym->st_value );
+        entry.size          = convertor( pSym->st_size );
+        entry.bind          = ELF_ST_BIND( pSym->st_info );
+        entry.type          = ELF_ST_TYPE( pSym->st_info );
+        entry.section_index = convertor( pSym->st_shndx );
+        entry.other         = pSym->st_other;
+
+        return entry;
+    }
+
+//------------------------------------------------------------------------------
+  private:
+    std::string_view
+    get_name( Elf_Word offset ) const
+    {
+        if ( 0 == strings || offset >= strings_size ) {
+            return std::string_view();
+        }
+
+        const char* name = strings + offset;
+        const void* end  = std::memchr( name, '\0', strings_size - offset );
+        return std::string_view( name, 0 != end ? static_cast<const char*>( end ) - name
+                                                : strings_size - offset );
+    }
+
+//------------------------------------------------------------------------------
+    const char*                entries;
+    Elf_Xword                  entry_size;
+    Elf_Xword                  count;
+    const char*                strings;
+    Elf_Xword                  strings_size;
+    C                          convertor;
+};
+
 //------------------------------------------------------------------------------
 class symbol_section_accessor
 {
@@ -75,6 +186,49 @@ class symbol_section_accessor
     }
 
 //------------------------------------------------------------------------------
+    // Allocation free access to every symbol. `T` must match the ELF class
+    template< class T >
+    symbol_table_view<T>
+    get_view() const
+    {
+        return get_view<T>( elf_file.get_convertor() );
+    }
+
+//------------------------------------------------------------------------------
+    // Same with a convertor fixed at compile time (fixed_endianess_convertor),
+    // which must match the ELF encoding
+    template< class T, class C >
+    symbol_table_view<T, C>
+    get_view( const C& convertor ) const
+    {
+        const section* string_section = elf_file.sections[get_string_table_index()];
+        const char*    strings        = 0;
+        Elf_Xword      strings_size   = 0;
+        if ( 0 != string_section ) {
+            strings      = string_section->get_data();
+            strings_size = string_section->get_size();
+        }
+
+        Elf_Xword entry_size = symbol_section->get_entry_size();
+        if ( 0 == entry_size ) {
+            entry_size = sizeof( T );
+        }
+
+        return symbol_table_view<T, C>( symbol_section->get_data(), entry_size,
+                                        get_symbols_num(), strings, strings_size,
+                                        convertor );
+    }
+
+//------------------------------------------------------------------------------
+    bool
+    has_hash_table() const
+    {
+        return 0 != get_hash_table_index();
+    }
+
+//------------------------------------------------------------------------------
+    // Look up a symbol through the `.hash` section. Returns false when there
+    // is no hash section, so the caller can fall back to a linear search
     bool
     get_symbol( const std::string& name,
                 Elf64_Addr&        value,
@@ -87,22 +241,31 @@ class symbol_section_accessor
         bool ret = false;
 
         if ( 0 != get_hash_table_index() ) {
-            Elf_Word nbucket = *(Elf_Word*)hash_section->get_data();
-            Elf_Word nchain  = *(Elf_Word*)( hash_section->get_data() +
-                                   sizeof( Elf_Word ) );
-            Elf_Word val     = elf_hash( (const unsigned char*)name.c_str() );
-
-            Elf_Word y   = *(Elf_Word*)( hash_section->get_data() +
-                               ( 2 + val % nbucket ) * sizeof( Elf_Word ) );
-            std::string   str;
-            get_symbol( y, str, value, size, bind, type, section_index, other );
-            while ( str != name && STN_UNDEF != y && y < nchain ) {
-                y = *(Elf_Word*)( hash_section->get_data() +
-                        ( 2 + nbucket + y ) * sizeof( Elf_Word ) );
-                get_symbol( y, str, value, size, bind, type, section_index, other );
+            const endianess_convertor& convertor = elf_file.get_convertor();
+
+            const Elf_Word* table =
+                reinterpret_cast<const Elf_Word*>( hash_section->get_data() );
+            Elf_Xword words = hash_section->get_size() / sizeof( Elf_Word );
+            if ( 0 == table || words < 2 ) {
+                return false;
             }
-            if (  str == name ) {
-                ret = true;
+
+            Elf_Word nbucket = convertor( table[0] );
+            Elf_Word nchain  = convertor( table[1] );
+            if ( 0 == nbucket || words < 2 + (Elf_Xword)nbucket + nchain ) {
+                return false;
+            }
+
+            Elf_Word    val = elf_hash( (const unsigned char*)name.c_str() );
+            std::string str;
+            for ( Elf_Word y = convertor( table[2 + val % nbucket] );
+                  STN_UNDEF != y && y < nchain;
+                  y = convertor( table[2 + nbucket + y] ) ) {
+                if ( get_symbol( y, str, value, size, bind, type, section_index, other ) &&
+                     str == name ) {
+                    ret = true;
+                    break;
+                }
             }
         }
 
@@ -179,7 +342,8 @@ class symbol_section_accessor
         Elf_Half nSecNo = elf_file.sections.size();
         for ( Elf_Half i = 0; i < nSecNo && 0 == hash_section_index; ++i ) {
             const section* sec = elf_file.sections[i];
-            if ( sec->get_link() == symbol_section->get_index() ) {
+            if ( sec->get_type() == SHT_HASH &&
+                 sec->get_link() == symbol_section->get_index() ) {
                 hash_section       = sec;
                 hash_section_index = i;
             }
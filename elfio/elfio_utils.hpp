@@ -55,6 +55,13 @@ THE SOFTWARE.
     virtual TYPE get_##NAME() const = 0;        \
     virtual void set_##NAME( TYPE value ) = 0
 
+#if defined( __BYTE_ORDER__ ) && defined( __ORDER_BIG_ENDIAN__ ) && \
+    __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define ELFIO_HOST_ENCODING ELFDATA2MSB
+#else
+#define ELFIO_HOST_ENCODING ELFDATA2LSB
+#endif
+
 namespace ELFIO {
 
 //------------------------------------------------------------------------------
@@ -188,6 +195,93 @@ class endianess_convertor {
 };
 
 
+//------------------------------------------------------------------------------
+// Conversion from an encoding known at compile time. Loops specialized on it
+// read the fields with plain loads or byte swaps, without testing anything
+template< unsigned char elf_file_encoding >
+class fixed_endianess_convertor {
+  public:
+//------------------------------------------------------------------------------
+    fixed_endianess_convertor()
+    {
+    }
+
+//------------------------------------------------------------------------------
+    uint64_t
+    operator()( uint64_t value ) const
+    {
+        if constexpr ( !need_conversion ) {
+            return value;
+        }
+        return ( (uint64_t)(*this)( (uint32_t)value ) << 32 ) |
+               (*this)( (uint32_t)( value >> 32 ) );
+    }
+
+//------------------------------------------------------------------------------
+    int64_t
+    operator()( int64_t value ) const
+    {
+        return (int64_t)(*this)( (uint64_t)value );
+    }
+
+//------------------------------------------------------------------------------
+    uint32_t
+    operator()( uint32_t value ) const
+    {
+        if constexpr ( !need_conversion ) {
+            return value;
+        }
+        return ( ( value & 0x000000FF ) << 24 ) |
+               ( ( value & 0x0000FF00 ) <<  8 ) |
+               ( ( value & 0x00FF0000 ) >>  8 ) |
+               ( ( value & 0xFF000000 ) >> 24 );
+    }
+
+//------------------------------------------------------------------------------
+    int32_t
+    operator()( int32_t value ) const
+    {
+        return (int32_t)(*this)( (uint32_t)value );
+    }
+
+//------------------------------------------------------------------------------
+    uint16_t
+    operator()( uint16_t value ) const
+    {
+        if constexpr ( !need_conversion ) {
+            return value;
+        }
+        return (uint16_t)( ( ( value & 0x00FF ) << 8 ) |
+                           ( ( value & 0xFF00 ) >> 8 ) );
+    }
+
+//------------------------------------------------------------------------------
+    int16_t
+    operator()( int16_t value ) const
+    {
+        return (int16_t)(*this)( (uint16_t)value );
+    }
+
+//------------------------------------------------------------------------------
+    int8_t
+    operator()( int8_t value ) const
+    {
+        return value;
+    }
+
+//------------------------------------------------------------------------------
+    uint8_t
+    operator()( uint8_t value ) const
+    {
+        return value;
+    }
+
+//------------------------------------------------------------------------------
+  private:
+    static constexpr bool need_conversion = elf_file_encoding != ELFIO_HOST_ENCODING;
+};
+
+
 //------------------------------------------------------------------------------
 inline
 uint32_t
@@ -840,6 +840,13 @@ class OptionParser
 
     const Option& lookup_long_opt(const std::string& opt) const
     {
+        // An exact match wins over abbreviations, like Python's optparse
+        std::map<std::string, Option const*>::const_iterator exact = _optmap_l.find(opt);
+        if (exact != _optmap_l.end())
+        {
+            return *exact->second;
+        }
+
         std::vector<std::string> matching;
         for (std::map<std::string, Option const*>::const_iterator it = _optmap_l.begin();
              it != _optmap_l.end(); ++it)